@@ -0,0 +1,38 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+using std::atomic;
+using std::make_shared;
+using std::shared_ptr;
+
+// Token to cancel a run from another thread.
+// Copies share the same flag so the caller keeps a copy and cancels it while the solver checks it between steps.
+class CancellationToken
+{
+private:
+
+	//Flag shared by every copy of the token
+	shared_ptr<atomic<bool>> cancelled;
+
+public:
+
+	//Start out not cancelled
+	inline CancellationToken() : cancelled(make_shared<atomic<bool>>(false)) {};
+
+	//Using default Copy Constructor (copies share the flag)
+	inline CancellationToken(const CancellationToken&) = default;
+
+	//Default Assign operator
+	inline CancellationToken& operator=(const CancellationToken&) = default;
+
+	//Default Delete operator
+	inline ~CancellationToken() = default;
+
+	//Ask the run to stop
+	inline void cancel() const { cancelled->store(true, std::memory_order_release); };
+
+	//Check if the run was asked to stop
+	inline bool isCancelled() const { return cancelled->load(std::memory_order_acquire); };
+};
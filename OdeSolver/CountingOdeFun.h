@@ -0,0 +1,31 @@
+#pragma once
+
+#include "OdeFunIF.h"
+
+// Wraps a problem counting every right hand side evaluation into a counter owned by the caller.
+// Batched calls are passed straight through so the problem keeps its batched operator and count each state they evaluate.
+// The counter is not synchronized so each method thread wraps the problem with its own counter.
+class CountingOdeFun : public OdeFunIF
+{
+private:
+
+	//The problem we are counting
+	const OdeFunIF* problem;
+
+	//Where the evaluations are counted
+	size_t& evaluations;
+
+public:
+
+	//Wrap the problem counting into the counter
+	inline CountingOdeFun(const OdeFunIF* problemIn, size_t& evaluationsIn) : problem(problemIn), evaluations(evaluationsIn) {};
+
+	//Count and evaluate one state
+	inline virtual rvec operator()(rvec derivative, crvec state, const double& time) const override { ++evaluations; return problem->operator()(derivative, state, time); };
+
+	//Count and evaluate a packed block of states
+	inline virtual rvec operator()(rvec derivatives, crvec states, const timeVec& times) const override { evaluations += times.size(); return problem->operator()(derivatives, states, times); };
+
+	//Batch if the problem does
+	inline virtual const bool isBatched() const override { return problem->isBatched(); };
+};
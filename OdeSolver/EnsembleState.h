@@ -0,0 +1,148 @@
+#pragma once
+
+#include <stdexcept>
+#include <valarray>
+#include <vector>
+
+#include "SolverIF.h"
+
+using std::invalid_argument;
+using std::valarray;
+using std::vector;
+using vec = valarray<scalar>;
+using crvec = const vec&;
+using rvec = vec&;
+
+// Class to pack many members of an ensemble into one structure of arrays state.
+// Component c of member m is stored at c * members + m so every update over a component runs contiguously over all members.
+class EnsembleState
+{
+private:
+
+	//All the members packed component by component
+	vec packedState;
+
+	//Number of members in the ensemble
+	size_t members;
+
+	//Number of components of each member
+	size_t components;
+
+public:
+
+	//Pack the inital conditions of each member
+	inline EnsembleState(const vector<vec>&);
+
+	//Using default Copy Constructor
+	inline EnsembleState(const EnsembleState&) = default;
+
+	//Using default Move Constructor
+	inline EnsembleState(EnsembleState&&) = default;
+
+	//Default Assign operator
+	inline EnsembleState& operator=(const EnsembleState&) = default;
+
+	//Default Move Assign Operator
+	inline EnsembleState& operator=(EnsembleState&&) = default;
+
+	//Default Delete operator
+	inline ~EnsembleState() = default;
+
+	//Get the packed state
+	inline crvec getPackedState() const { return packedState; };
+
+	//Get the number of members
+	inline size_t getMembers() const { return members; };
+
+	//Get the number of components of each member
+	inline size_t getComponents() const { return components; };
+
+	//Copy one member out of a packed state
+	inline static void getMember(crvec, const size_t, const size_t, rvec);
+
+	//Copy one member into a packed state
+	inline static void setMember(rvec, const size_t, const size_t, crvec);
+
+	//Repeat a per member value across every component of a packed state
+	inline static void tile(const timeVec&, rvec);
+};
+
+/// <summary>
+/// Pack each members inital condition. All members must have the same number of components.
+/// </summary>
+/// <param name="memberStates"></param>
+EnsembleState::EnsembleState(const vector<vec>& memberStates) :
+	members(memberStates.size()),
+	components(memberStates.empty() ? 0 : memberStates.front().size())
+{
+	//Check we have something to pack
+	if (members == 0 || components == 0)
+	{
+		throw invalid_argument("Empty Ensemble");
+	}
+
+	//Size our packed state
+	packedState.resize(members * components);
+
+	//Pack each member
+	for (size_t member = 0; member < members; ++member)
+	{
+		//Every member must be the same size
+		if (memberStates[member].size() != components)
+		{
+			throw invalid_argument("Ensemble members must be the same size");
+		}
+
+		setMember(packedState, members, member, memberStates[member]);
+	}
+}
+
+/// <summary>
+/// Copy the member out of the packed state into memberState (sized by the caller)
+/// </summary>
+/// <param name="packed"></param>
+/// <param name="memberCount"></param>
+/// <param name="member"></param>
+/// <param name="memberState"></param>
+void EnsembleState::getMember(crvec packed, const size_t memberCount, const size_t member, rvec memberState)
+{
+	for (size_t i = 0; i < memberState.size(); ++i)
+	{
+		memberState[i] = packed[i * memberCount + member];
+	}
+}
+
+/// <summary>
+/// Copy memberState into the packed state for the member
+/// </summary>
+/// <param name="packed"></param>
+/// <param name="memberCount"></param>
+/// <param name="member"></param>
+/// <param name="memberState"></param>
+void EnsembleState::setMember(rvec packed, const size_t memberCount, const size_t member, crvec memberState)
+{
+	for (size_t i = 0; i < memberState.size(); ++i)
+	{
+		packed[i * memberCount + member] = memberState[i];
+	}
+}
+
+/// <summary>
+/// Expand one value per member so it lines up with every component of the packed state
+/// </summary>
+/// <param name="perMember"></param>
+/// <param name="packed"></param>
+void EnsembleState::tile(const timeVec& perMember, rvec packed)
+{
+	//Number of members we are tiling over
+	const size_t memberCount = perMember.size();
+
+	//Copy the members into each component block
+	for (size_t i = 0; i < packed.size(); i += memberCount)
+	{
+		for (size_t member = 0; member < memberCount; ++member)
+		{
+			packed[i + member] = static_cast<scalar>(perMember[member]);
+		}
+	}
+}
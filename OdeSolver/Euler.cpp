@@ -10,6 +10,7 @@ void Euler::initalizeSolverVectors()
 
 	//Update the current solver vector size
 	currentMethod.k1.resize(currentMethod.getCurrentState().size());
+	currentMethod.stageState.resize(currentMethod.getCurrentState().size());
 }
 
 /// <summary>
@@ -58,7 +59,7 @@ rvec Euler::update(crvec			previousState,
 		k1 = functionVector->operator()(k1, currentState, currentTime);
 
 		//Update to the next time step and save the current state
-		currentState += dt * k1;
+		addScaled(currentState, currentState, dt, k1);
 
 		//Update the time step to the next time
 		updateTimeStep(dt, currentTime);
@@ -71,6 +72,139 @@ rvec Euler::update(crvec			previousState,
 	return newState;
 }
 
+/// <summary>
+/// Find the state of every active ensemble member at the next time step. Each member steps with its own dt from its own time
+/// and members that are not active are left where they are.
+/// </summary>
+/// <param name="previousStates"></param>
+/// <param name="newStates"></param>
+/// <param name="dts"></param>
+/// <param name="times"></param>
+/// <param name="numOfSteps"></param>
+/// <param name="active"></param>
+/// <param name="functionVector"></param>
+/// <returns></returns>
+rvec Euler::update(crvec			previousStates,
+				   rvec				newStates,
+				   const timeVec&	dts,
+				   const timeVec&	times,
+				   const int&		numOfSteps,
+				   const maskVec&	active,
+				   const OdeFunIF*	functionVector)
+{
+	//Update the currentState
+	currentState = previousStates;
+
+	//Save each members current time
+	ensembleTimes = times;
+
+	//Line each members dt up with the packed state
+	if (ensembleDt.size() != previousStates.size())
+	{
+		ensembleDt.resize(previousStates.size());
+	}
+	EnsembleState::tile(dts, ensembleDt);
+
+	//Iterate through time
+	for (int i = 0; i < numOfSteps; ++i)
+	{
+		//Get the function vector for each member at its current time
+		evaluateEnsemble(functionVector, k1, currentState, ensembleTimes, active);
+
+		//Update every member to its next time step
+		addScaled(currentState, currentState, 1.0, ensembleDt, k1);
+
+		//Update each members time
+		ensembleTimes += dts;
+	}
+
+	//Save off the final current state to the new state
+	newStates = currentState;
+
+	//Return the new states
+	return newStates;
+}
+
+/// <summary>
+/// Evaluate the function derivative vector for each active member of the packed states with one batched call.
+/// If some members are masked we gather the active ones into a smaller batch first. Inactive members get a zero derivative so they do not move.
+/// </summary>
+/// <param name="functionVector"></param>
+/// <param name="derivatives"></param>
+/// <param name="states"></param>
+/// <param name="memberTimes"></param>
+/// <param name="active"></param>
+void Euler::evaluateEnsemble(const OdeFunIF* functionVector, rvec derivatives, crvec states, const timeVec& memberTimes, const maskVec& active)
+{
+	//Get the packed sizes
+	const size_t memberCount = memberTimes.size();
+	const size_t componentCount = states.size() / memberCount;
+
+	//Count the members we need to evaluate
+	const size_t activeCount = static_cast<size_t>(std::count(std::begin(active), std::end(active), true));
+
+	//Make sure the derivatives line up with the states
+	if (derivatives.size() != states.size())
+	{
+		derivatives.resize(states.size());
+	}
+
+	//Evaluate everyone in place if nobody is masked
+	if (activeCount == memberCount)
+	{
+		functionVector->operator()(derivatives, states, memberTimes);
+		return;
+	}
+
+	//Make sure we have scratch for this batch size
+	if (batchStates.size() <= activeCount)
+	{
+		batchStates.resize(activeCount + 1);
+		batchDerivatives.resize(activeCount + 1);
+		batchTimes.resize(activeCount + 1);
+	}
+
+	//Get the scratch for this batch size and size it the first time we see it
+	vec& currentBatchStates = batchStates[activeCount];
+	vec& currentBatchDerivatives = batchDerivatives[activeCount];
+	timeVec& currentBatchTimes = batchTimes[activeCount];
+	if (currentBatchStates.size() != activeCount * componentCount)
+	{
+		currentBatchStates.resize(activeCount * componentCount);
+		currentBatchDerivatives.resize(activeCount * componentCount);
+		currentBatchTimes.resize(activeCount);
+	}
+
+	//Gather the active members
+	for (size_t member = 0, batchMember = 0; member < memberCount; ++member)
+	{
+		if (active[member])
+		{
+			for (size_t i = 0; i < componentCount; ++i)
+			{
+				currentBatchStates[i * activeCount + batchMember] = states[i * memberCount + member];
+			}
+			currentBatchTimes[batchMember++] = memberTimes[member];
+		}
+	}
+
+	//Evaluate the batch
+	if (activeCount > 0)
+	{
+		functionVector->operator()(currentBatchDerivatives, currentBatchStates, currentBatchTimes);
+	}
+
+	//Scatter the derivatives back and zero the masked members
+	for (size_t member = 0, batchMember = 0; member < memberCount; ++member)
+	{
+		for (size_t i = 0; i < componentCount; ++i)
+		{
+			derivatives[i * memberCount + member] = active[member] ? currentBatchDerivatives[i * activeCount + batchMember] : static_cast<scalar>(0.0);
+		}
+		batchMember += static_cast<size_t>(active[member]);
+	}
+}
+
 /// <summary>
 /// This runs the implict calculations. We will throw here as euler is not implict
 /// </summary>
@@ -1,13 +1,17 @@
 #pragma once
 
+#include <algorithm>
 #include <valarray>
+#include <vector>
 
+#include "EnsembleState.h"
 #include "OdeFunIF.h"
 #include "SolverIF.h"
 
 //Convience for writing out methods
 using std::valarray;
-using vec = valarray<double>;
+using std::vector;
+using vec = valarray<scalar>;
 using crvec = const vec&;
 using rvec = vec&;
 
@@ -19,6 +23,25 @@ protected:
 	// Hold the functions derivative vector at the current time step. Used to "move" to current state vector in time
 	vec k1;
 
+	// Scratch for the state and times a stage is evaluated at
+	vec stageState;
+	timeVec stageTimes;
+
+	// Each ensemble members dt repeated over the packed components
+	vec ensembleDt;
+
+	// Each ensemble members current time
+	timeVec ensembleTimes;
+
+	// Scratch for gathering the active ensemble members into one batch.
+	// We keep one set per batch size so masking members in and out does not reallocate.
+	vector<vec> batchStates;
+	vector<vec> batchDerivatives;
+	vector<timeVec> batchTimes;
+
+	// Evaluate the function derivative vector for every active member of a packed ensemble
+	void evaluateEnsemble(const OdeFunIF*, rvec, crvec, const timeVec&, const maskVec&);
+
 private:
 
 	// Update the vectors that are used to appoximate the function vectors derivative at other time steps
@@ -47,6 +70,9 @@ public:
 	//Get the next time step for rvec for implict methods
 	virtual rvec update(crvec, rvec, const double&, const double&, const int&, const OdeFunIF*, const double&, const double&) override;
 
+	//Get the next time step for every active member of a packed ensemble
+	virtual rvec update(crvec, rvec, const timeVec&, const timeVec&, const int&, const maskVec&, const OdeFunIF*) override;
+
 	/// Return the error order of the Euler method
 	virtual const double getErrorOrder() const override;
 };
@@ -1,25 +1,76 @@
 #include "FirstOrderScheme.h"
 
+/// <summary>
+/// Evaluate the unperturbed derivative once and then the perturbed columns in one batched call.
+/// Each column is written straight into A (sized once in solve).
+/// </summary>
+/// <param name="problemIn"></param>
+/// <param name="currentTime"></param>
+/// <param name="methodDt"></param>
 void FirstOrderScheme::getJacobian(const OdeFunIF* problemIn, const double& currentTime, const double& methodDt)
 {
-	valarray<double> temp1, temp2;
-
-	//Initalize our Jacobian
-	for (size_t i = 0; i < A.size(); ++i)
+	//Size the unperturbed derivative since the problem writes into it in place
+	if (baseDerivative.size() != guessLeft.size())
 	{
-		//Copy over the guess for modification
-		valarray<double> copyGuess = guessLeft;
+		baseDerivative.resize(guessLeft.size());
+	}
 
-		//Update the element we are taking the derivative for
-		copyGuess[i] += dt;
+	//Evaluate the unperturbed state once for every column
+	problemIn->operator()(baseDerivative, guessLeft, currentTime + methodDt);
 
-		A[i] = -(methodDt / dt) * (problemIn->operator()(temp1, copyGuess, currentTime + methodDt) - (problemIn->operator()(temp2, guessLeft, currentTime + methodDt)));
-	}
+	//Fill the columns
+	getBatchedColumns(problemIn, currentTime, methodDt);
 
 	//Add one down the eyes
 	for (size_t i = 0; i < A.size(); ++i)
 	{
 		A[i][i] += 1.0;
 	}
+}
+
+/// <summary>
+/// Pack every perturbed state and evaluate them with one call to the batched operator
+/// </summary>
+/// <param name="problemIn"></param>
+/// <param name="currentTime"></param>
+/// <param name="methodDt"></param>
+void FirstOrderScheme::getBatchedColumns(const OdeFunIF* problemIn, const double& currentTime, const double& methodDt)
+{
+	//Each column is one perturbed state
+	const size_t columns = A.size();
+	const size_t stateSize = guessLeft.size();
+
+	//Size our packed storage
+	if (jacobianStates.size() != columns * stateSize)
+	{
+		jacobianStates.resize(columns * stateSize);
+		jacobianDerivatives.resize(columns * stateSize);
+	}
+	if (jacobianTimes.size() != columns)
+	{
+		jacobianTimes.resize(columns);
+	}
+	jacobianTimes = currentTime + methodDt;
 
+	//Pack a copy of the guess into each column and perturb the element we are taking the derivative for
+	for (size_t i = 0; i < stateSize; ++i)
+	{
+		jacobianStates[std::slice(i * columns, columns, 1)] = guessLeft[i];
+		if (i < columns)
+		{
+			jacobianStates[i * columns + i] += dt;
+		}
+	}
+
+	//Evaluate every column at once
+	problemIn->operator()(jacobianDerivatives, jacobianStates, jacobianTimes);
+
+	//Fill in our Jacobian
+	for (size_t i = 0; i < columns; ++i)
+	{
+		for (size_t j = 0; j < stateSize; ++j)
+		{
+			A[i][j] = -(methodDt / dt) * (jacobianDerivatives[j * columns + i] - baseDerivative[j]);
+		}
+	}
 }
@@ -1,10 +1,26 @@
 #pragma once
 #include "LinAlgHelperBase.h"
+
 class FirstOrderScheme : public LinAlgHelperBase
 {
 private:
 
+	//The derivative at the unperturbed guess (evaluated once per jacobian)
+	vec baseDerivative;
+
+	//Packed perturbed states, their derivatives, and times for the batched jacobian evaluation
+	vec jacobianStates;
+	vec jacobianDerivatives;
+	timeVec jacobianTimes;
+
+	//Evaluate every column in one batched call
+	void getBatchedColumns(const OdeFunIF*, const double&, const double&);
+
 	//Override our function for the jacobian
 	virtual void getJacobian(const OdeFunIF*, const double&, const double&) override;
-};
 
+public:
+
+	//Build with the tolerance, perturbation, and max iterations of the helper
+	using LinAlgHelperBase::LinAlgHelperBase;
+};
@@ -6,10 +6,11 @@ void LinAlgHelperBase::getFuncDer(const OdeFunIF* problemIn, const double& curre
 	problemIn->operator()(funcVec, guessLeft, currentTime);
 }
 
-const valarray<double> LinAlgHelperBase::solveSystem()
+const vec& LinAlgHelperBase::solveSystem()
 {
 	//Our result vector
-	valarray<double> result = funcVec;
+	vec& result = solution;
+	result = funcVec;
 
 	//Matrix size (assuming it is square..will need a check here)
 	const size_t jSize = A.size();
@@ -55,13 +56,36 @@ const valarray<double> LinAlgHelperBase::solveSystem()
 LinAlgHelperBase::LinAlgHelperBase(const double& errorTolIn, const double& dtIn, const unsigned int& maxItrIn) :
 	errorTol(errorTolIn),
 	dt(dtIn),
-	maxIter(maxItrIn)
+	maxIter(maxItrIn),
+	newtonIterations(0),
+	jacobianBuilds(0)
 {
 	//Nothing else to do here
 }
 
-const valarray<double>& LinAlgHelperBase::solve(const double& currentTime, const double& methodDt, const valarray<double>& currentState, const OdeFunIF* problemIn)
+const vec& LinAlgHelperBase::solve(const double& currentTime, const double& methodDt, const vec& currentState, const OdeFunIF* problemIn)
 {
+	//Count what the newton solve allocates as linear algebra
+	MemoryScope memoryScope(MemoryTracker::CATEGORIES::LINEAR_ALGEBRA);
+
+	//Size our scratch since the problem writes into it in place
+	if (guessRight.size() != currentState.size())
+	{
+		guessRight.resize(currentState.size());
+		funcVec.resize(currentState.size());
+		storageVec.resize(currentState.size());
+	}
+
+	//Size the jacobian once so each column is written into storage we already have (every row, since the rows we keep are the old size)
+	if (A.size() != currentState.size() || (A.size() > 0 && A[0].size() != currentState.size()))
+	{
+		A.resize(currentState.size());
+		for (vec& row : A)
+		{
+			row.resize(currentState.size());
+		}
+	}
+
 	//Generate our first pair of guesses
 	guessLeft = currentState;
 	guessRight = currentState + methodDt * problemIn->operator()(guessRight, guessLeft, currentTime);
@@ -72,16 +96,14 @@ const valarray<double>& LinAlgHelperBase::solve(const double& currentTime, const
 	//Set our current iteration count
 	unsigned int iter = 0;
 
-	//Initalize our error vector
-	valarray<double> errorVec;
-
-	valarray<double> storageVec;
-
 	//Iterate
 	do
 	{
 		//Generate the Jacobian for A
+		TraceSpan jacobianSpan(Tracer::SPAN_TYPES::JACOBIAN_BUILD);
 		getJacobian(problemIn, currentTime, methodDt);
+		jacobianSpan.end();
+		++jacobianBuilds;
 
 		//Generate the function derv vector
 		getFuncDer(problemIn, currentTime);
@@ -92,25 +114,24 @@ const valarray<double>& LinAlgHelperBase::solve(const double& currentTime, const
 		try
 		{
 			//Solve our system
-			guessLeft += -solveSystem();
+			TraceSpan solveSpan(Tracer::SPAN_TYPES::LINEAR_SOLVE);
+			guessLeft -= solveSystem();
+
+			//Only a solve that updated our guess counts as a newton iteration
+			++newtonIterations;
 		}
 		catch (std::exception& e)
 		{
 			std::cerr << e.what();
 		}
 
-		//Find the error vector
-		errorVec = guessLeft - guessRight;
-
-		//Get the absolute value of each element
-		std::for_each(std::begin(errorVec), std::end(errorVec), 
-			[](double& a)
-			{
-				a *= a;
-			});
-
-		//Get the 2 normed error
-		error = std::sqrt(errorVec.sum());
+		//Get the 2 normed error between our guesses without building an error vector
+		error = 0.0;
+		for (size_t i = 0; i < guessLeft.size(); ++i)
+		{
+			error += (guessLeft[i] - guessRight[i]) * (guessLeft[i] - guessRight[i]);
+		}
+		error = std::sqrt(error);
 
 		//Update the vectors
 		guessRight = guessLeft;
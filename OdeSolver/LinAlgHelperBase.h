@@ -6,7 +6,9 @@
 #include <stdexcept>
 #include <valarray>
 
+#include "MemoryTracker.h"
 #include "OdeFunIF.h"
+#include "Tracer.h"
 
 using std::valarray;
 
@@ -15,16 +17,22 @@ class LinAlgHelperBase
 protected:
 
 	//Matrix A
-	valarray<valarray<double>> A;
+	valarray<vec> A;
 
 	//Our left guess
-	valarray<double> guessLeft;
+	vec guessLeft;
 
 	//Our right guess
-	valarray<double> guessRight;
+	vec guessRight;
 
 	//Our function vector
-	valarray<double> funcVec;
+	vec funcVec;
+
+	//Scratch for the function evaluated at our guess
+	vec storageVec;
+
+	//Scratch for the solved update
+	vec solution;
 
 	//Error tolerance
 	double errorTol;
@@ -35,14 +43,18 @@ protected:
 	//For the partial derivatives
 	double dt;
 
+	//Newton iterations and jacobians built over every solve
+	size_t newtonIterations;
+	size_t jacobianBuilds;
+
 	//Generate the Jacobian
 	virtual void getJacobian(const OdeFunIF*, const double&, const double&) = 0;
 
 	//Generate the function derivative vector
 	void getFuncDer(const OdeFunIF*, const double&);
 
-	//Solver the system
-	const valarray<double> solveSystem();
+	//Solver the system into our solution
+	const vec& solveSystem();
 
 public:
 
@@ -61,8 +73,12 @@ public:
 	//Default destructor
 	virtual ~LinAlgHelperBase() = default;
 
+	//Get the newton iterations and jacobians built over every solve
+	inline size_t getNewtonIterations() const { return newtonIterations; };
+	inline size_t getJacobianBuilds() const { return jacobianBuilds; };
+
 	//Solve the problem
-	const valarray<double>& solve(const double&, const double&, const valarray<double>&, const OdeFunIF*);
+	const vec& solve(const double&, const double&, const vec&, const OdeFunIF*);
 	
 };
 
@@ -7,7 +7,7 @@
 /// <param name=""></param>
 /// <param name=""></param>
 /// <param name=""></param>
-void LinearAlgIF::buildFuncDer(const OdeFunIF* problemIn, valarray<double>& resultIn, const valarray<double>& currentStateIn, const double& currentTimeIn)
+void LinearAlgIF::buildFuncDer(const OdeFunIF* problemIn, vec& resultIn, const vec& currentStateIn, const double& currentTimeIn)
 {
 	//Generate the result
 	problemIn->operator()(resultIn, currentStateIn, currentTimeIn);
@@ -17,13 +17,13 @@ void LinearAlgIF::buildFuncDer(const OdeFunIF* problemIn, valarray<double>& resu
 /// Solve the system of linear equations. Using a simple model for now - later parallize it
 /// </summary>
 /// <returns></returns>
-const valarray<double> LinearAlgIF::solveSystem()
+const vec LinearAlgIF::solveSystem()
 {
 	//Vector size
 	const size_t vectorSize = leftDfDt.size();
 
 	//Temp storage for the resukt
-	valarray<double> result(vectorSize);
+	vec result(vectorSize);
 
 	//Iterate through the elements and solve // Will need to think harder here
 	for (size_t i = 0; i < vectorSize; ++i)
@@ -54,7 +54,7 @@ void LinearAlgIF::initalize(const size_t& vectorSizeIn, const double& allowedErr
 	rightResult.resize(vectorSizeIn);
 	leftResult.resize(vectorSizeIn);
 	J.resize(vectorSizeIn);
-	for_each(std::begin(J), std::end(J), [&vectorSizeIn](valarray<double>& rowIn)
+	for_each(std::begin(J), std::end(J), [&vectorSizeIn](vec& rowIn)
 		{
 			rowIn.resize(vectorSizeIn);
 		});
@@ -15,19 +15,19 @@ class LinearAlgIF
 protected:
 
 	//Storage for the Jacobian
-	valarray<valarray<double>> J;
+	valarray<vec> J;
 
 	//Our left result
-	valarray<double> leftResult;
+	vec leftResult;
 
 	//Our right result
-	valarray<double> rightResult;
+	vec rightResult;
 
 	//Our left function derivative
-	valarray<double> leftDfDt;
+	vec leftDfDt;
 
 	//Our right function derivative
-	valarray<double> rightDfDt;
+	vec rightDfDt;
 
 	//Control the iterations
 	unsigned int maxIterAllowed;
@@ -41,13 +41,13 @@ protected:
 private:
 
 	//Build our Jacobian
-	virtual void buildJacbian(const OdeFunIF*, const valarray<double>&, const double&) = 0;
+	virtual void buildJacbian(const OdeFunIF*, const vec&, const double&) = 0;
 
 	//Build our function vector
-	void buildFuncDer(const OdeFunIF*, valarray<double>&, const valarray<double>&, const double&);
+	void buildFuncDer(const OdeFunIF*, vec&, const vec&, const double&);
 
 	//Solve our system of linear equations
-	const valarray<double> solveSystem();
+	const vec solveSystem();
 
 public:
 
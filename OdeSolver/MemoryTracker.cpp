@@ -0,0 +1,232 @@
+#include "MemoryTracker.h"
+
+#include <cstdlib>
+#include <new>
+
+thread_local unsigned int MemoryTracker::threadMethod = 0;
+thread_local MemoryTracker::CATEGORIES MemoryTracker::threadCategory = MemoryTracker::CATEGORIES::OTHER;
+
+/// <summary>
+/// Turn counting on
+/// </summary>
+void MemoryTracker::enable()
+{
+	enabled().store(true, std::memory_order_relaxed);
+}
+
+/// <summary>
+/// Turn counting off
+/// </summary>
+void MemoryTracker::disable()
+{
+	enabled().store(false, std::memory_order_relaxed);
+}
+
+/// <summary>
+/// Get if we are counting
+/// </summary>
+/// <returns></returns>
+atomic<bool>& MemoryTracker::enabled()
+{
+	static atomic<bool> isOn(false);
+	return isOn;
+}
+
+/// <summary>
+/// Get the counters of a method and category. Method ids past the ones we keep share the counters of zero.
+/// </summary>
+/// <param name="methodId"></param>
+/// <param name="category"></param>
+/// <returns></returns>
+MemoryTracker::Counter& MemoryTracker::counter(const unsigned int methodId, const CATEGORIES category)
+{
+	static Counter counters[maxMethodId + 1][static_cast<size_t>(CATEGORIES::CATEGORY_COUNT)];
+	return counters[methodId <= maxMethodId ? methodId : 0][static_cast<size_t>(category)];
+}
+
+/// <summary>
+/// Get what a method holds in a category
+/// </summary>
+/// <param name="methodId"></param>
+/// <param name="category"></param>
+/// <returns></returns>
+MemoryTracker::Usage MemoryTracker::getUsage(const unsigned int methodId, const CATEGORIES category)
+{
+	const Counter& current = counter(methodId, category);
+
+	Usage usage;
+	usage.currentBytes = current.currentBytes.load(std::memory_order_relaxed);
+	usage.peakBytes = current.peakBytes.load(std::memory_order_relaxed);
+	usage.allocations = current.allocations.load(std::memory_order_relaxed);
+	return usage;
+}
+
+/// <summary>
+/// Add up the blocks a method allocated in every category
+/// </summary>
+/// <param name="methodId"></param>
+/// <returns></returns>
+size_t MemoryTracker::getAllocations(const unsigned int methodId)
+{
+	size_t allocations = 0;
+	for (size_t category = 0; category < static_cast<size_t>(CATEGORIES::CATEGORY_COUNT); ++category)
+	{
+		allocations += counter(methodId, static_cast<CATEGORIES>(category)).allocations.load(std::memory_order_relaxed);
+	}
+
+	return allocations;
+}
+
+/// <summary>
+/// Start the peaks of a method over from what it holds now and its allocation counts from zero
+/// </summary>
+/// <param name="methodId"></param>
+void MemoryTracker::restart(const unsigned int methodId)
+{
+	for (size_t category = 0; category < static_cast<size_t>(CATEGORIES::CATEGORY_COUNT); ++category)
+	{
+		Counter& current = counter(methodId, static_cast<CATEGORIES>(category));
+		current.peakBytes.store(current.currentBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		current.allocations.store(0, std::memory_order_relaxed);
+	}
+}
+
+/// <summary>
+/// Get the name of a category
+/// </summary>
+/// <param name="category"></param>
+/// <returns></returns>
+const char* MemoryTracker::categoryName(const CATEGORIES category)
+{
+	switch (category)
+	{
+	case CATEGORIES::TABLES:
+		return "tables";
+	case CATEGORIES::RESULTS:
+		return "results";
+	case CATEGORIES::STAGES:
+		return "stages";
+	case CATEGORIES::LINEAR_ALGEBRA:
+		return "linear algebra";
+	default:
+		return "other";
+	}
+}
+
+/// <summary>
+/// Allocate the block with a header in front naming who it is counted under (nobody if we are not counting) and count it
+/// </summary>
+/// <param name="bytes"></param>
+/// <returns></returns>
+void* MemoryTracker::allocate(const size_t bytes)
+{
+	void* block = std::malloc(sizeof(BlockHeader) + bytes);
+	if (block == nullptr)
+	{
+		return nullptr;
+	}
+
+	//Name who the block is counted under
+	BlockHeader* header = static_cast<BlockHeader*>(block);
+	header->bytes = bytes;
+	header->methodId = threadMethod;
+	header->category = static_cast<unsigned int>(CATEGORIES::CATEGORY_COUNT);
+
+	//Count it
+	if (isEnabled())
+	{
+		header->category = static_cast<unsigned int>(threadCategory);
+
+		Counter& current = counter(threadMethod, threadCategory);
+		current.allocations.fetch_add(1, std::memory_order_relaxed);
+		const long long held = current.currentBytes.fetch_add(static_cast<long long>(bytes), std::memory_order_relaxed) + static_cast<long long>(bytes);
+
+		//Raise the peak if we went past it
+		long long peak = current.peakBytes.load(std::memory_order_relaxed);
+		while (held > peak && !current.peakBytes.compare_exchange_weak(peak, held, std::memory_order_relaxed))
+		{
+		}
+	}
+
+	return header + 1;
+}
+
+/// <summary>
+/// Take the block off the counters it was counted under and free it
+/// </summary>
+/// <param name="pointer"></param>
+void MemoryTracker::release(void* pointer)
+{
+	if (pointer == nullptr)
+	{
+		return;
+	}
+
+	BlockHeader* header = static_cast<BlockHeader*>(pointer) - 1;
+	if (header->category < static_cast<unsigned int>(CATEGORIES::CATEGORY_COUNT))
+	{
+		counter(header->methodId, static_cast<CATEGORIES>(header->category)).currentBytes.fetch_sub(static_cast<long long>(header->bytes), std::memory_order_relaxed);
+	}
+
+	std::free(header);
+}
+
+#if defined(ODESOLVER_COUNT_ALLOCATIONS)
+
+//Replace the global allocator so every container is counted, valarray included since it can not take an allocator
+void* operator new(size_t bytes)
+{
+	void* block = MemoryTracker::allocate(bytes);
+	if (block == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+	return block;
+}
+
+void* operator new[](size_t bytes)
+{
+	return operator new(bytes);
+}
+
+void* operator new(size_t bytes, const std::nothrow_t&) noexcept
+{
+	return MemoryTracker::allocate(bytes);
+}
+
+void* operator new[](size_t bytes, const std::nothrow_t&) noexcept
+{
+	return MemoryTracker::allocate(bytes);
+}
+
+void operator delete(void* pointer) noexcept
+{
+	MemoryTracker::release(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+	MemoryTracker::release(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+	MemoryTracker::release(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept
+{
+	MemoryTracker::release(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept
+{
+	MemoryTracker::release(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept
+{
+	MemoryTracker::release(pointer);
+}
+
+#endif
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+using std::atomic;
+
+// Optional counting layer over the global allocator showing how much memory each method holds and what for.
+// Built with ODESOLVER_COUNT_ALLOCATIONS the global operator new and delete put a small header in front of every block naming the
+// method and category the allocating thread was in, so the block comes off the same counters wherever it is freed.
+// A thread picks its method and category with a MemoryScope. The counters are kept per method id for the whole process, so solvers
+// running the same methods at the same time share them. Without the flag nothing is counted and the scopes do nothing.
+class MemoryTracker
+{
+public:
+
+	//Enumerations for what the memory is used for
+	enum class CATEGORIES
+	{
+		TABLES			= 0, //Richardson tableau storage
+		RESULTS			= 1, //The saved states and parameters of each step
+		STAGES			= 2, //Method stage vectors and arena scratch
+		LINEAR_ALGEBRA	= 3, //Jacobians and newton workspace of the implict methods
+		OTHER			= 4, //Anything allocated outside a scope
+		CATEGORY_COUNT
+	};
+
+	//What one method holds in one category, its most since it was restarted, and the blocks it allocated since then
+	struct Usage
+	{
+		long long currentBytes = 0;
+		long long peakBytes = 0;
+		size_t allocations = 0;
+	};
+
+	//Check if the counting layer was built in
+	inline static constexpr bool isAvailable()
+	{
+#if defined(ODESOLVER_COUNT_ALLOCATIONS)
+		return true;
+#else
+		return false;
+#endif
+	};
+
+	//Turn counting on or off (blocks allocated while off are never counted)
+	static void enable();
+	static void disable();
+
+	//Check if we are counting
+	inline static bool isEnabled() { return enabled().load(std::memory_order_relaxed); };
+
+	//Get what a method holds in a category
+	static Usage getUsage(const unsigned int, const CATEGORIES);
+
+	//Get how many blocks a method allocated over every category
+	static size_t getAllocations(const unsigned int);
+
+	//Start the peaks of a method over from what it holds now and its allocation counts from zero
+	static void restart(const unsigned int);
+
+	//Get the name of a category to print
+	static const char* categoryName(const CATEGORIES);
+
+	//Allocate and free a counted block (used by the global operator new and delete)
+	static void* allocate(const size_t);
+	static void release(void*);
+
+private:
+
+	//Largest method id with its own counters, anything past it is counted under zero
+	static constexpr unsigned int maxMethodId = 64;
+
+	//The counters of one method and category
+	struct Counter
+	{
+		atomic<long long> currentBytes{ 0 };
+		atomic<long long> peakBytes{ 0 };
+		atomic<size_t> allocations{ 0 };
+	};
+
+	//Header in front of each block, padded so the block keeps the alignment new promises
+	struct alignas(alignof(std::max_align_t)) BlockHeader
+	{
+		size_t bytes;
+		unsigned int methodId;
+		unsigned int category;
+	};
+
+	//The calling threads method and category (plain thread locals so the allocator skips the thread local constructor check)
+	static thread_local unsigned int threadMethod;
+	static thread_local CATEGORIES threadCategory;
+
+	//Shared state (function statics so they are built before the first allocation from any thread)
+	static atomic<bool>& enabled();
+	static Counter& counter(const unsigned int, const CATEGORIES);
+
+	friend class MemoryScope;
+};
+
+// Scope that counts what the calling thread allocates under a category (and method) until it ends, then puts back what was there
+class MemoryScope
+{
+#if defined(ODESOLVER_COUNT_ALLOCATIONS)
+private:
+
+	//What to put back
+	const unsigned int previousMethod;
+	const MemoryTracker::CATEGORIES previousCategory;
+
+public:
+
+	//Count under the category on the calling threads method
+	inline explicit MemoryScope(const MemoryTracker::CATEGORIES category) :
+		previousMethod(MemoryTracker::threadMethod),
+		previousCategory(MemoryTracker::threadCategory)
+	{
+		MemoryTracker::threadCategory = category;
+	};
+
+	//Count under the category and method
+	inline MemoryScope(const MemoryTracker::CATEGORIES category, const unsigned int methodId) :
+		previousMethod(MemoryTracker::threadMethod),
+		previousCategory(MemoryTracker::threadCategory)
+	{
+		MemoryTracker::threadMethod = methodId;
+		MemoryTracker::threadCategory = category;
+	};
+
+	//Put back what was there
+	inline ~MemoryScope()
+	{
+		MemoryTracker::threadMethod = previousMethod;
+		MemoryTracker::threadCategory = previousCategory;
+	};
+#else
+public:
+
+	//Nothing is counted
+	inline explicit MemoryScope(const MemoryTracker::CATEGORIES) {};
+	inline MemoryScope(const MemoryTracker::CATEGORIES, const unsigned int) {};
+#endif
+
+	//Can not copy a scope
+	MemoryScope(const MemoryScope&) = delete;
+	MemoryScope& operator=(const MemoryScope&) = delete;
+};
@@ -0,0 +1,119 @@
+#include "MethodArena.h"
+
+/// <summary>
+/// Size all our buffers up front so the first steps do not have to
+/// </summary>
+/// <param name="vecSize"></param>
+/// <param name="maxTableSize"></param>
+void MethodArena::initalize(const size_t vecSize, const size_t maxTableSize)
+{
+	getBuffer(ARENA_BUFFERS::CURRENT_STATE, vecSize);
+	getBuffer(ARENA_BUFFERS::NEW_STATE, vecSize);
+	getBuffer(ARENA_BUFFERS::ROW_STATES, vecSize * maxTableSize);
+	getBuffer(ARENA_BUFFERS::BEST_STATE, vecSize);
+	getTimeBuffer(TIME_BUFFERS::ROW_DTS, maxTableSize);
+	getTimeBuffer(TIME_BUFFERS::ROW_TIMES, maxTableSize);
+	getRowMask(maxTableSize);
+	getRowSteps(maxTableSize);
+}
+
+/// <summary>
+/// Get the buffer and make sure it is the size asked for. Resizing only happens when the size changes.
+/// </summary>
+/// <param name="buffer"></param>
+/// <param name="size"></param>
+/// <returns></returns>
+rvec MethodArena::getBuffer(const ARENA_BUFFERS buffer, const size_t size)
+{
+	//Get the buffer
+	vec& currentBuffer = buffers[static_cast<size_t>(buffer)];
+
+	//Resize if needed
+	if (currentBuffer.size() != size)
+	{
+		currentBuffer.resize(size);
+	}
+
+	return currentBuffer;
+}
+
+/// <summary>
+/// Get the time buffer and make sure it is the size asked for. Resizing only happens when the size changes.
+/// </summary>
+/// <param name="buffer"></param>
+/// <param name="size"></param>
+/// <returns></returns>
+timeVec& MethodArena::getTimeBuffer(const TIME_BUFFERS buffer, const size_t size)
+{
+	//Get the buffer
+	timeVec& currentBuffer = timeBuffers[static_cast<size_t>(buffer)];
+
+	//Resize if needed
+	if (currentBuffer.size() != size)
+	{
+		currentBuffer.resize(size);
+	}
+
+	return currentBuffer;
+}
+
+/// <summary>
+/// Get the row mask and make sure it is the size asked for
+/// </summary>
+/// <param name="size"></param>
+/// <returns></returns>
+maskVec& MethodArena::getRowMask(const size_t size)
+{
+	//Resize if needed
+	if (rowMask.size() != size)
+	{
+		rowMask.resize(size);
+	}
+
+	return rowMask;
+}
+
+/// <summary>
+/// Get the row steps and make sure it is the size asked for
+/// </summary>
+/// <param name="size"></param>
+/// <returns></returns>
+vector<int>& MethodArena::getRowSteps(const size_t size)
+{
+	//Resize if needed (keeps capacity so shrinking and growing back does not allocate)
+	rowSteps.resize(size);
+
+	return rowSteps;
+}
+
+/// <summary>
+/// Get the pending member mask and make sure it is the size asked for
+/// </summary>
+/// <param name="size"></param>
+/// <returns></returns>
+maskVec& MethodArena::getPendingMask(const size_t size)
+{
+	//Resize if needed
+	if (pendingMask.size() != size)
+	{
+		pendingMask.resize(size);
+	}
+
+	return pendingMask;
+}
+
+/// <summary>
+/// Get the member errors and make sure they are the size asked for
+/// </summary>
+/// <param name="size"></param>
+/// <returns></returns>
+accVec& MethodArena::getMemberErrors(const size_t size)
+{
+	//Resize if needed
+	if (memberErrors.size() != size)
+	{
+		memberErrors.resize(size);
+	}
+
+	return memberErrors;
+}
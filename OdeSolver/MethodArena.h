@@ -0,0 +1,97 @@
+#pragma once
+
+#include <array>
+#include <valarray>
+#include <vector>
+
+#include "SolverIF.h"
+
+using std::array;
+using std::valarray;
+using std::vector;
+using vec = valarray<scalar>;
+using rvec = vec&;
+using maskVec = valarray<bool>;
+
+// Class to hold the scratch space one method needs to take a step.
+// Each method thread owns one so after the first few steps have sized the buffers the time loop does not allocate.
+class MethodArena
+{
+public:
+
+	//Enumerations for the buffers held in the arena
+	enum class ARENA_BUFFERS
+	{
+		CURRENT_STATE	= 0,
+		NEW_STATE		= 1,
+		ROW_STATES		= 2,
+		BEST_STATE		= 3,
+		MEMBER_STATE	= 4,
+		BUFFER_COUNT	= 5
+	};
+
+	//Enumerations for the time buffers held in the arena
+	enum class TIME_BUFFERS
+	{
+		ROW_DTS			= 0,
+		ROW_TIMES		= 1,
+		MEMBER_DTS		= 2,
+		STEP_DTS		= 3,
+		BUFFER_COUNT	= 4
+	};
+
+private:
+
+	//Our scratch vectors
+	array<vec, static_cast<size_t>(ARENA_BUFFERS::BUFFER_COUNT)> buffers;
+
+	//Our scratch time vectors
+	array<timeVec, static_cast<size_t>(TIME_BUFFERS::BUFFER_COUNT)> timeBuffers;
+
+	//Scratch mask for the rows still running
+	maskVec rowMask;
+
+	//Scratch for the number of steps in each row
+	vector<int> rowSteps;
+
+	//Scratch mask for the ensemble members still searching for their dt
+	maskVec pendingMask;
+
+	//Scratch for each ensemble members error
+	accVec memberErrors;
+
+public:
+
+	//Using default constructor
+	MethodArena() = default;
+
+	//Using default copy constructor
+	MethodArena(const MethodArena&) = default;
+
+	//Using default assignment operator
+	MethodArena& operator=(const MethodArena&) = default;
+
+	//Using default destructor
+	~MethodArena() = default;
+
+	//Size the buffers for the state and the largest richardson table we will use
+	void initalize(const size_t, const size_t);
+
+	//Get a buffer with the given size. Only allocates if the size changed.
+	rvec getBuffer(const ARENA_BUFFERS, const size_t);
+
+	//Get a time buffer with the given size. Only allocates if the size changed.
+	timeVec& getTimeBuffer(const TIME_BUFFERS, const size_t);
+
+	//Get the row mask with the given size
+	maskVec& getRowMask(const size_t);
+
+	//Get the row steps with the given size
+	vector<int>& getRowSteps(const size_t);
+
+	//Get the pending member mask with the given size
+	maskVec& getPendingMask(const size_t);
+
+	//Get the member errors with the given size
+	accVec& getMemberErrors(const size_t);
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+using std::vector;
+
+// Counters one method collects over a run, read after the run through OdeSolver::getStats.
+// Each method thread only updates its own stats so none of these are synchronized.
+struct MethodStats
+{
+	//Right hand side evaluations (a batched call counts each state it evaluates)
+	size_t rhsEvaluations = 0;
+
+	//Steps accepted into the results
+	size_t acceptedSteps = 0;
+
+	//Richardson tables thrown away and built again with a new dt or table size
+	size_t retries = 0;
+
+	//Number of accepted steps built with each table size (indexed by the table size)
+	vector<size_t> tableSizeHistogram;
+
+	//Times the step was clamped to the smallest allowable dt
+	size_t dtClamps = 0;
+
+	//Steps replayed from a schedule that kept to the error and the ones that missed it and fell back to adaptive control
+	size_t replayedSteps = 0;
+	size_t replayFallbacks = 0;
+
+	//Real time steps accepted without meeting the error because they ran out of retries or budget
+	size_t budgetOverruns = 0;
+
+	//Blocks allocated under the method over the run (zero unless allocation counting is built in and turned on)
+	size_t allocations = 0;
+
+	//Wall time spent stepping the rows of the tables and extrapolating them
+	double steppingTime = 0.0;
+	double extrapolationTime = 0.0;
+
+	//Longest wall time any one step took from its first dt update to being accepted (the worst case step latency)
+	double worstStepTime = 0.0;
+
+	//Count an accepted step built with the table size
+	inline void countTableSize(const size_t tableSize) { if (tableSizeHistogram.size() <= tableSize) { tableSizeHistogram.resize(tableSize + 1, 0); } ++tableSizeHistogram[tableSize]; };
+};
@@ -48,6 +48,30 @@ Richardson& MethodWrapperBase::findTable(SolverIF::SOLVER_TYPES solver)
 	}
 }
 
+/// <summary>
+/// Finds the scratch arena based on the method enumeration.
+/// </summary>
+/// <param name="solver"></param>
+/// <returns></returns>
+MethodArena& MethodWrapperBase::findArena(SolverIF::SOLVER_TYPES solver)
+{
+	//Convert solver types to int for the map
+	unsigned int solverInt = static_cast<unsigned int>(solver);
+
+	//Get an iterator to the arena
+	arenaMap::iterator foundArena = arenas.find(solverInt);
+
+	//Check if arena was found
+	if (foundArena == arenas.end())
+	{
+		throw invalid_argument("Invalid Method");
+	}
+	else
+	{
+		return foundArena->second;
+	}
+}
+
 /// <summary>
 /// Initalizes all the methods with the size of our vector.
 /// </summary>
@@ -59,6 +83,7 @@ void MethodWrapperBase::updateForVectorSize(const vec& state)
 	{
 		//Get the method we are trying to allocate
 		methodPtr& currentMethod = currentMethodItr->second;
+		MemoryScope memoryScope(MemoryTracker::CATEGORIES::STAGES, currentMethodItr->first);
 
 		try
 		{
@@ -107,6 +132,15 @@ const tableMap& MethodWrapperBase::getTableMap() const
 	return tables;
 }
 
+/// <summary>
+/// Get the arena map.
+/// </summary>
+/// <returns></returns>
+arenaMap& MethodWrapperBase::getArenaMap()
+{
+	return arenas;
+}
+
 /// <summary>
 /// Build up our richardson tables for each allowed method
 /// </summary>
@@ -119,6 +153,18 @@ void MethodWrapperBase::buildTables()
 	}
 }
 
+/// <summary>
+/// Build up a scratch arena for each allowed method
+/// </summary>
+void MethodWrapperBase::buildArenas()
+{
+	//Go through what methods we are using and add an arena to each one
+	for (methodMap::const_iterator methodIter = methods.cbegin(); methodIter != methods.cend(); ++methodIter)
+	{
+		arenas.emplace(methodIter->first, MethodArena());
+	}
+}
+
 void MethodWrapperBase::initalize(const OdeSolverParams& paramsIn)
 {
 	//Build the solvers
@@ -126,6 +172,9 @@ void MethodWrapperBase::initalize(const OdeSolverParams& paramsIn)
 
 	//Build the tables
 	buildTables();
+
+	//Build the arenas
+	buildArenas();
 }
 
 void MethodWrapperBase::updateForRichardsonTables(const size_t tableSize, const double reductionFactor, const double baseStepSize)
@@ -135,6 +184,7 @@ void MethodWrapperBase::updateForRichardsonTables(const size_t tableSize, const
 	{
 		//Current table
 		Richardson& currentTable = richItr->second;
+		MemoryScope memoryScope(MemoryTracker::CATEGORIES::TABLES, richItr->first);
 
 		//Current vector size
 		size_t currentVectorSize = findMethod(static_cast<SolverIF::SOLVER_TYPES>(richItr->first))->getCurrentState().size();
@@ -147,6 +197,20 @@ void MethodWrapperBase::updateForRichardsonTables(const size_t tableSize, const
 	}
 }
 
+/// <summary>
+/// Size every arena for the state and the largest table so the time loop does not allocate
+/// </summary>
+/// <param name="state"></param>
+/// <param name="tableSize"></param>
+void MethodWrapperBase::updateForArenas(const vec& state, const size_t tableSize)
+{
+	for (arenaMap::iterator arenaItr = arenas.begin(); arenaItr != arenas.end(); ++arenaItr)
+	{
+		MemoryScope memoryScope(MemoryTracker::CATEGORIES::STAGES, arenaItr->first);
+		arenaItr->second.initalize(state.size(), tableSize);
+	}
+}
+
 void MethodWrapperBase::updateAll(const vec& state, const size_t tableSize, const double reductionFactor, const double baseStepSize)
 {
 	//Update the vector sizes
@@ -154,6 +218,46 @@ void MethodWrapperBase::updateAll(const vec& state, const size_t tableSize, cons
 
 	//Update each richardson table
 	updateForRichardsonTables(tableSize, reductionFactor, baseStepSize);
+
+	//Update each arena
+	updateForArenas(state, tableSize);
+}
+
+/// <summary>
+/// Throw away one methods table and arena and build them again along with its vectors.
+/// Everything is allocated and first written by the calling thread so a pinned thread gets the memory on its own node.
+/// </summary>
+/// <param name="methodId"></param>
+/// <param name="state"></param>
+/// <param name="tableSize"></param>
+/// <param name="reductionFactor"></param>
+/// <param name="baseStepSize"></param>
+void MethodWrapperBase::updateMethod(const unsigned int methodId, const vec& state, const size_t tableSize, const double reductionFactor, const double baseStepSize)
+{
+	//Update the methods vectors
+	MemoryScope memoryScope(MemoryTracker::CATEGORIES::STAGES, methodId);
+	try
+	{
+		methods.find(methodId)->second->initalize(state);
+	}
+	catch (exception& e)
+	{
+		cerr << e.what();
+	}
+
+	//Start a new table so its storage is ours
+	Richardson& currentTable = tables.find(methodId)->second;
+	{
+		MemoryScope tableScope(MemoryTracker::CATEGORIES::TABLES);
+		currentTable = Richardson();
+		currentTable.initalizeSteps(reductionFactor, baseStepSize);
+		currentTable.BuildTables(tableSize, state.size());
+	}
+
+	//Start a new arena so its scratch is ours
+	MethodArena& currentArena = arenas.find(methodId)->second;
+	currentArena = MethodArena();
+	currentArena.initalize(state.size(), tableSize);
 }
 
 //Build up our solvers
@@ -220,4 +324,7 @@ void MethodWrapperBase::clearMethods()
 
 	//Clear our tables
 	tables.clear();
+
+	//Clear our arenas
+	arenas.clear();
 }
\ No newline at end of file
@@ -7,6 +7,8 @@
 #include <valarray>
 
 #include "Euler.h"
+#include "MemoryTracker.h"
+#include "MethodArena.h"
 #include "Richardson.h"
 #include "RK2.h"
 #include "RK4.h"
@@ -18,10 +20,11 @@ using std::map;
 using std::unique_ptr;
 using std::exception;
 using std::valarray;
-using vec = valarray<double>;
+using vec = valarray<scalar>;
 using methodPtr = unique_ptr<SolverIF>;
 using methodMap = map<unsigned int, methodPtr>;
 using tableMap = map<unsigned int, Richardson>;
+using arenaMap = map<unsigned int, MethodArena>;
 using std::invalid_argument;
 
 //This class will set up the other types of method wrappers
@@ -35,12 +38,18 @@ private:
 	//Build the tables
 	void buildTables();
 
+	//Build the scratch arenas
+	void buildArenas();
+
 	//Our method map
 	methodMap methods;
 
 	//Our table map
 	tableMap tables;
 
+	//Our scratch arena map
+	arenaMap arenas;
+
 public:
 
 	//Using default constructor
@@ -76,21 +85,33 @@ public:
 	//Get a const referance to the table map
 	const tableMap& getTableMap() const;
 
+	//Get a referance to the arena map
+	arenaMap& getArenaMap();
+
 	//Get the solver we want to use
 	methodPtr& findMethod(SolverIF::SOLVER_TYPES);
 
 	//Get pointer to tables
 	Richardson& findTable(SolverIF::SOLVER_TYPES);
 
+	//Get the scratch arena for a method
+	MethodArena& findArena(SolverIF::SOLVER_TYPES);
+
 	//Update all the methods vectors for new vector size
 	void updateForVectorSize(const vec&);
 
 	//Update all tables for the Richardson Table Sizes
 	void updateForRichardsonTables(const size_t, const double, const double);
 
+	//Update all arenas for the vector size and largest table
+	void updateForArenas(const vec&, const size_t);
+
 	//Update all the methods vectors for new vector size
 	void updateAll(const vec&, const size_t, const double, const double);
 
+	//Rebuild one methods vectors, table, and arena from scratch on the calling thread
+	void updateMethod(const unsigned int, const vec&, const size_t, const double, const double);
+
 	//Clear out all the methods we used
 	void clearMethods();
 };
@@ -1,9 +1,11 @@
 #pragma once
 #include <valarray>
 
+#include "ScalarTraits.h"
+
 //Convience for writing out methods
 using std::valarray;
-using vec = valarray<double>;
+using vec = valarray<scalar>;
 using crvec = const vec&;
 using rvec = vec&;
 
@@ -15,5 +17,68 @@ public:
 	virtual rvec operator()(rvec,
 							crvec,
 							const double&) const = 0;
+
+	//Optional batched operator to evaluate a block of states at their times in one call.
+	//The states and derivatives are packed component by component so component i of state j is at i * times.size() + j.
+	//The default evaluates each state on its own.
+	inline virtual rvec operator()(rvec,
+								   crvec,
+								   const timeVec&) const;
+
+	//Override to return true when the batched operator is cheaper than the single one so the solver gathers evaluations for it
+	inline virtual const bool isBatched() const { return false; };
+
+	//Use default deconstructor
+	virtual ~OdeFunIF() = default;
 };
 
+/// <summary>
+/// Evaluate each packed state at its time with the single state operator
+/// </summary>
+/// <param name="derivatives"></param>
+/// <param name="states"></param>
+/// <param name="times"></param>
+/// <returns></returns>
+rvec OdeFunIF::operator()(rvec derivatives, crvec states, const timeVec& times) const
+{
+	//Get the block sizes
+	const size_t count = times.size();
+	const size_t components = count == 0 ? 0 : states.size() / count;
+
+	//Scratch for one state, kept per thread since every method thread shares the problem and this runs on each ensemble stage
+	static thread_local vec state;
+	static thread_local vec derivative;
+	if (state.size() != components)
+	{
+		state.resize(components);
+		derivative.resize(components);
+	}
+
+	//Make sure the derivatives line up with the states
+	if (derivatives.size() != states.size())
+	{
+		derivatives.resize(states.size());
+	}
+
+	//Evaluate each state
+	for (size_t j = 0; j < count; ++j)
+	{
+		//Pull out the state
+		for (size_t i = 0; i < components; ++i)
+		{
+			state[i] = states[i * count + j];
+		}
+
+		//Evaluate it
+		const vec& result = operator()(derivative, state, times[j]);
+
+		//Put the derivative back
+		for (size_t i = 0; i < components; ++i)
+		{
+			derivatives[i * count + j] = result[i];
+		}
+	}
+
+	//Return the derivatives
+	return derivatives;
+}
@@ -1,5 +1,11 @@
 #include "OdeSolver.h"
 
+//Storage for our reserve limit
+const size_t OdeSolver::maxReservedResults;
+
+//Storage for our race progress limit
+constexpr double OdeSolver::minRaceProgress;
+
 /// <summary>
 /// This constructor calls the set up method which builds up all our tables and maps to later be used when we decide to run.
 /// </summary>
@@ -7,6 +13,13 @@
 OdeSolver::OdeSolver(const OdeSolverParams& paramsIn) :
 	generalParams(paramsIn)
 {
+	//Build a progress slot for every method once so readers never see the map change between runs
+	for (const SolverIF::SOLVER_TYPES methodType : { SolverIF::SOLVER_TYPES::EULER, SolverIF::SOLVER_TYPES::RUNGE_KUTTA_TWO,
+		SolverIF::SOLVER_TYPES::RUNGE_KUTTA_FOUR, SolverIF::SOLVER_TYPES::IMPLICT_EULER, SolverIF::SOLVER_TYPES::CRANK_NICOLSON })
+	{
+		progressSlots.emplace(static_cast<unsigned int>(methodType), std::make_unique<ProgressSlot>());
+	}
+
 	setup();
 }
 
@@ -18,16 +31,27 @@ OdeSolver::OdeSolver(const OdeSolverParams& paramsIn) :
 /// <param name="problem"></param>
 /// <param name="method"></param>
 /// <param name="tables"></param>
+/// <param name="arena"></param>
 /// <param name="initalCondition"></param>
 /// <param name="newState"></param>
 /// <param name="currentParams"></param>
 /// <param name="initalTime"></param>
 /// <param name="newTime"></param>
-void OdeSolver::runMethod(const OdeFunIF* problem, unique_ptr<SolverIF>& method, const unsigned int currentMethodId, Richardson& tables, crvec initalCondition, rvec newState, const OdeSolverParams& currentParams, const double initalTime, const double newTime)
+void OdeSolver::runMethod(const OdeFunIF* problem, unique_ptr<SolverIF>& method, const unsigned int currentMethodId, Richardson& tables, MethodArena& arena, crvec initalCondition, rvec newState, const OdeSolverParams& currentParams, const double initalTime, const double newTime)
 {
+	//Run the rows together if the problem would rather evaluate in batches
+	if (problem->isBatched() && isExplict(currentMethodId))
+	{
+		TraceSpan batchedSpan(Tracer::SPAN_TYPES::RUN_BATCHED_ROWS, static_cast<int>(tables.getTableSize()));
+		runBatchedRows(problem, method, tables, arena, initalCondition, newState, currentParams, initalTime);
+		return;
+	}
+
 	//Loop over all the tables
 	for (unsigned int i = 0; i < tables.getTableSize(); ++i)
 	{
+		TraceSpan rowSpan(Tracer::SPAN_TYPES::RUN_METHOD_ROW, static_cast<int>(i));
+
 		//Check if we are using an implict method
 		if (isExplict(currentMethodId))
 		{
@@ -47,6 +71,88 @@ void OdeSolver::runMethod(const OdeFunIF* problem, unique_ptr<SolverIF>& method,
 
 		//Add the result into the tables
 		tables.append(i, 0, newState);
+
+		//Stop between rows if the run was asked to stop
+		if (isStopRequested())
+		{
+			return;
+		}
+	}
+}
+
+/// <summary>
+/// The rows of the richardson table are independent so we treat each row as an ensemble member with its own dt.
+/// Every lockstep pass moves each row that still has steps left, so the rows share one batched function evaluation per stage.
+/// </summary>
+/// <param name="problem"></param>
+/// <param name="method"></param>
+/// <param name="tables"></param>
+/// <param name="arena"></param>
+/// <param name="initalCondition"></param>
+/// <param name="newState"></param>
+/// <param name="currentParams"></param>
+/// <param name="initalTime"></param>
+void OdeSolver::runBatchedRows(const OdeFunIF* problem, unique_ptr<SolverIF>& method, Richardson& tables, MethodArena& arena, crvec initalCondition, rvec newState, const OdeSolverParams& currentParams, const double initalTime)
+{
+	//Number of rows we are running together. We always pack the largest table so the packed size never changes between steps
+	//and the rows we do not use are masked out for the whole run.
+	const size_t usedRows = tables.getTableSize();
+	const size_t rows = std::max(usedRows, currentParams.maxTableSize);
+
+	//Each rows dt, time, and number of steps (from the arena so we do not allocate each step)
+	timeVec& rowDts = arena.getTimeBuffer(MethodArena::TIME_BUFFERS::ROW_DTS, rows);
+	timeVec& rowTimes = arena.getTimeBuffer(MethodArena::TIME_BUFFERS::ROW_TIMES, rows);
+	vector<int>& rowSteps = arena.getRowSteps(rows);
+	for (size_t i = 0; i < rows; ++i)
+	{
+		rowDts[i] = i < usedRows ? currentParams.dt / pow(tables.getReductionFactor(), static_cast<double>(i)) : 0.0;
+		rowTimes[i] = initalTime;
+		rowSteps[i] = i < usedRows ? static_cast<int>(pow(tables.getReductionFactor(), static_cast<double>(i))) : 0;
+	}
+
+	//Every row starts from the inital condition
+	vec& rowStates = arena.getBuffer(MethodArena::ARENA_BUFFERS::ROW_STATES, initalCondition.size() * rows);
+	for (size_t i = 0; i < rows; ++i)
+	{
+		EnsembleState::setMember(rowStates, rows, i, initalCondition);
+	}
+
+	//Rows that still have steps to take
+	maskVec& active = arena.getRowMask(rows);
+
+	//Step all the rows together until the finest row is done
+	for (int step = 0; step < rowSteps[usedRows - 1]; ++step)
+	{
+		for (size_t i = 0; i < rows; ++i)
+		{
+			active[i] = step < rowSteps[i];
+		}
+
+		//Move each active row one step
+		method->update(rowStates, rowStates, rowDts, rowTimes, 1, active, problem);
+
+		//Update each active rows time
+		for (size_t i = 0; i < rows; ++i)
+		{
+			rowTimes[i] += active[i] ? rowDts[i] : 0.0;
+		}
+
+		//Stop between passes if the run was asked to stop
+		if (isStopRequested())
+		{
+			return;
+		}
+	}
+
+	//Add each row into the tables
+	if (newState.size() != initalCondition.size())
+	{
+		newState.resize(initalCondition.size());
+	}
+	for (size_t i = 0; i < usedRows; ++i)
+	{
+		EnsembleState::getMember(rowStates, rows, i, newState);
+		tables.append(i, 0, newState);
 	}
 }
 
@@ -56,45 +162,191 @@ void OdeSolver::runMethod(const OdeFunIF* problem, unique_ptr<SolverIF>& method,
 /// </summary>
 /// <param name="currentMethod"></param>
 /// <param name="currentMethodId"></param>
+/// <param name="currentTable"></param>
+/// <param name="arena"></param>
+/// <param name="currentMethodParams"></param>
 /// <param name="initalCondition"></param>
+/// <param name="newState"></param>
 /// <param name="problem"></param>
 /// <param name="beginTime"></param>
 /// <param name="endTime"></param>
 /// <returns></returns>
-vec OdeSolver::buildSolution(unique_ptr<SolverIF>& currentMethod, const unsigned int currentMethodId, Richardson& currentTable, OdeSolverParams& currentMethodParams, crvec initalCondition, const OdeFunIF* problem,const double beginTime, const double endTime)
+rvec OdeSolver::buildSolution(unique_ptr<SolverIF>& currentMethod, const unsigned int currentMethodId, Richardson& currentTable, MethodArena& arena, OdeSolverParams& currentMethodParams, crvec initalCondition, rvec newState, const OdeFunIF* problem,const double beginTime, const double endTime)
 {
+	//Tag the spans this thread records with our method
+	Tracer::setThreadMethod(currentMethodId);
+
+	//Start timing the whole step for its latency and real time budget
+	const std::chrono::high_resolution_clock::time_point stepStart = std::chrono::high_resolution_clock::now();
+
 	//Reset the satisfaction criteria
 	currentMethodParams.satifiesError = false;
-
-	//Initalize our vector for the updated result
-	vec newState;
+	currentMethodParams.budgetExceeded = false;
 
 	//Set our inital convergence criterial the the theoretical local truncation error 
 	currentMethodParams.c = currentMethod->getErrorOrder() + static_cast<double>(currentMethodParams.minTableSize);
 
-	//Update dt with our convergence criteria
-	updateDt(currentMethodParams, true, beginTime, endTime);
+	//Update dt with our convergence criteria unless we are replaying a step here
+	const bool isReplayed = replayStep(currentMethodId, currentMethodParams, beginTime, endTime);
+	if (!isReplayed)
+	{
+		TraceSpan dtSpan(Tracer::SPAN_TYPES::UPDATE_DT);
+		updateDt(currentMethodParams, true, beginTime, endTime);
+	}
+
+	//Measure the error with the norm and tolerances asked for
+	currentTable.setErrorNorm(currentMethodParams);
 
 	//Get the current time
 	std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
 
+	//Get our counters
+	MethodStats& stats = statsMap.find(currentMethodId)->second;
+
+	//Count the tables we build so the ones thrown away show up as retries
+	size_t passes = 0;
+	size_t usedTableSize = currentMethodParams.currentTableSize;
+	bool isRetry = false;
+
+	//The table with the smallest error a real time step built so far, in case it runs out of retries or budget
+	const size_t stepRhsStart = stats.rhsEvaluations;
+	double bestError = std::numeric_limits<double>::infinity();
+	double bestDt = 0.0;
+	size_t bestTableSize = usedTableSize;
+	bool bestClamped = false;
+
+	//Right hand side steps it takes to fill the first column of a table (each row takes the reduction factor more than the last)
+	const auto tableWork = [&currentMethodParams](const size_t tableSize)
+	{
+		double work = 0.0;
+		for (size_t i = 0; i < tableSize; ++i)
+		{
+			work += std::floor(pow(currentMethodParams.redutionFactor, static_cast<double>(i)));
+		}
+		return work;
+	};
+
 	//Run each result several times
 	do
 	{
+		++passes;
+		usedTableSize = currentMethodParams.currentTableSize;
+		TraceSpan passSpan(Tracer::SPAN_TYPES::BUILD_SOLUTION, static_cast<int>(passes));
+
 		//Update our table
 		currentTable.initalizeSteps(currentMethodParams.redutionFactor, currentMethodParams.dt);
 
 		//Update the Richardson Table Size
-		currentTable.BuildTables(currentMethodParams.currentTableSize, initalCondition.size());
+		{
+			MemoryScope tableScope(MemoryTracker::CATEGORIES::TABLES);
+			currentTable.BuildTables(currentMethodParams.currentTableSize, initalCondition.size());
+		}
 
 		//Run our method
-		runMethod(problem, currentMethod, currentMethodId, currentTable, initalCondition, newState, currentMethodParams, beginTime, endTime);
+		const size_t passRhsStart = stats.rhsEvaluations;
+		std::chrono::high_resolution_clock::time_point stepBegin = std::chrono::high_resolution_clock::now();
+		runMethod(problem, currentMethod, currentMethodId, currentTable, arena, initalCondition, newState, currentMethodParams, beginTime, endTime);
+		std::chrono::high_resolution_clock::time_point stepEnd = std::chrono::high_resolution_clock::now();
+		stats.steppingTime += std::chrono::duration_cast<std::chrono::duration<double>>(stepEnd - stepBegin).count();
+
+		//If the run was stopped the table is not finished so we give up on this step and keep the state we had
+		if (isStopRequested())
+		{
+			currentMethodParams.isPartial = true;
+			newState = initalCondition;
+			return newState;
+		}
 
 		//Update the results with the new error
 		currentMethodParams.currentError = currentTable.error(newState, currentMethodParams.c);
+		stats.extrapolationTime += std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::high_resolution_clock::now() - stepEnd).count();
+
+		//Build more tables if the error is greater then the greatest error, counting when that clamps dt to the smallest we allow
+		const bool wasClamped = currentMethodParams.isDtClamped;
+		const double triedDt = currentMethodParams.dt;
+		TraceSpan dtSpan(Tracer::SPAN_TYPES::UPDATE_DT);
+		isRetry = updateDt(currentMethodParams, false, beginTime, endTime);
+		dtSpan.setDetail(isRetry ? 1 : 0);
+		stats.dtClamps += (isRetry && currentMethodParams.isDtClamped && !wasClamped) ? 1 : 0;
+
+		//In real time mode only retry if we have retries left and the next table is projected to fit in the budget (scaling what this
+		//pass cost by how much more work the next table is), otherwise keep the best table we built
+		if (isRetry && currentMethodParams.realTime)
+		{
+			const double nextShare = tableWork(currentMethodParams.currentTableSize) / tableWork(usedTableSize);
+			const double stepTime = std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::high_resolution_clock::now() - stepStart).count();
+			const double passTime = std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::high_resolution_clock::now() - stepBegin).count();
+			const double passRhs = static_cast<double>(stats.rhsEvaluations - passRhsStart);
+
+			const bool outOfRetries = passes > currentMethodParams.realTimeMaxRetries;
+			const bool outOfTime = stepTime + nextShare * passTime > currentMethodParams.realTimeBudget;
+			const bool outOfRhs = currentMethodParams.realTimeRhsBudget > 0 &&
+				static_cast<double>(stats.rhsEvaluations - stepRhsStart) + nextShare * passRhs > static_cast<double>(currentMethodParams.realTimeRhsBudget);
+			const bool isBest = !(bestDt > 0.0) || currentMethodParams.currentError < bestError;
+
+			if (outOfRetries || outOfTime || outOfRhs)
+			{
+				//Put back the best table, which is already in the new state if it was this one
+				if (isBest)
+				{
+					bestError = currentMethodParams.currentError;
+					bestDt = triedDt;
+					bestTableSize = usedTableSize;
+					bestClamped = wasClamped;
+				}
+				else
+				{
+					newState = arena.getBuffer(MethodArena::ARENA_BUFFERS::BEST_STATE, newState.size());
+				}
+
+				//Accept it with the error it has and do not grow dt from it, so the next step tries the same dt again
+				currentMethodParams.dt = bestDt;
+				currentMethodParams.currentTableSize = bestTableSize;
+				currentMethodParams.isDtClamped = bestClamped;
+				currentMethodParams.currentError = bestError;
+				currentMethodParams.totalError += bestError;
+				currentMethodParams.upgradeFactor = -1.0;
+				currentMethodParams.budgetExceeded = true;
+				usedTableSize = bestTableSize;
+				++stats.budgetOverruns;
+				isRetry = false;
+			}
+			else if (isBest)
+			{
+				//Save the table in case the retries do no better
+				arena.getBuffer(MethodArena::ARENA_BUFFERS::BEST_STATE, newState.size()) = newState;
+				bestError = currentMethodParams.currentError;
+				bestDt = triedDt;
+				bestTableSize = usedTableSize;
+				bestClamped = wasClamped;
+			}
+		}
+
+		//Let the observer know we threw the table away
+		if (isRetry && stepObserver != nullptr)
+		{
+			stepObserver->stepRejected(currentMethodId, beginTime, triedDt, currentMethodParams.currentError);
+		}
+	} while (isRetry);
+
+	//Every table but the last was a retry and the last one is the step we keep
+	stats.retries += passes - 1;
+	stats.countTableSize(usedTableSize);
+	stats.replayedSteps += (isReplayed && passes == 1) ? 1 : 0;
+	stats.replayFallbacks += (isReplayed && passes > 1) ? 1 : 0;
+
+	//Let adaptive control finish the span of a replayed step that missed the error
+	if (isReplayed && passes > 1)
+	{
+		ReplayPosition& position = replayPositions.find(currentMethodId)->second;
+		position.resumeTime = position.stepEnd;
+	}
 
-		//Build more tables if the error is greater then the greatest error
-	} while (updateDt(currentMethodParams, false, beginTime, endTime));
+	//Record the step we kept
+	if (stepRecording != nullptr)
+	{
+		stepRecording->record(currentMethodId, { beginTime, currentMethodParams.dt, usedTableSize });
+	}
 
 	//Get the second time point
 	std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
@@ -102,11 +354,57 @@ vec OdeSolver::buildSolution(unique_ptr<SolverIF>& currentMethod, const unsigned
 	//Save the duriation of time
 	currentMethodParams.currentRunTime = std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1).count();
 	currentMethodParams.totalTime += currentMethodParams.currentRunTime;
+	stats.worstStepTime = std::max(stats.worstStepTime, std::chrono::duration_cast<std::chrono::duration<double>>(t2 - stepStart).count());
 
 	//Return the new state found
 	return newState;
 }
 
+/// <summary>
+/// Take the dt and table size of the scheduled step at the begin time, resetting what the first pass of updateDt would.
+/// The last step of the interval (or slice) is left to updateDt so it lands on the end the way it always does.
+/// </summary>
+/// <param name="methodId"></param>
+/// <param name="currentParams"></param>
+/// <param name="beginTime"></param>
+/// <param name="endTime"></param>
+/// <returns></returns>
+const bool OdeSolver::replayStep(const unsigned int methodId, OdeSolverParams& currentParams, const double beginTime, const double endTime)
+{
+	//Check we are replaying and are not waiting out a step that missed the error
+	if (stepReplay == nullptr)
+	{
+		return false;
+	}
+	ReplayPosition& position = replayPositions.find(methodId)->second;
+	if (beginTime < position.resumeTime)
+	{
+		return false;
+	}
+
+	//Check we have a step here
+	ScheduledStep scheduledStep;
+	if (!stepReplay->findStep(methodId, beginTime, position.cursor, scheduledStep))
+	{
+		return false;
+	}
+
+	//Leave the step onto the end to updateDt
+	const double clampTime = currentParams.isStepping ? std::min(currentParams.sliceEnd, endTime) : endTime;
+	if (beginTime + scheduledStep.dt >= clampTime || currentParams.lastRun)
+	{
+		return false;
+	}
+
+	//Take the scheduled step
+	currentParams.dt = scheduledStep.dt;
+	currentParams.currentTableSize = std::min(std::max(scheduledStep.tableSize, currentParams.minTableSize), currentParams.maxTableSize);
+	currentParams.isDtClamped = false;
+	position.stepEnd = beginTime + scheduledStep.dt;
+
+	return true;
+}
+
 /// <summary>
 /// We check if dt is valid and supports the error goal.
 /// If dt fails the checks we find a new dt based on the convergence estimate. If we are on the last time step, we clamp dt so the
@@ -168,17 +466,22 @@ const bool OdeSolver::updateDt(OdeSolverParams& currentParams, const bool firstP
 		lastRun = false;
 		clamp = false;
 
-		//Check if we need to clamp dt if we are at the end point of the interval
-		if (dt + beginTime > endTime)
+		//Check if we need to clamp dt if we are at the end point of the interval (or the slice when stepping)
+		const double clampTime = currentParams.isStepping ? std::min(currentParams.sliceEnd, endTime) : endTime;
+		if (dt + beginTime > clampTime)
 		{
 			//Reset dt to end where we plan on it ending
-			dt = endTime - beginTime;
+			dt = clampTime - beginTime;
 
-			//Update table size to max to hope for better convergence since we don't control dt anymore
-			currentTableSize = maxTableSize;
+			//At the end of a slice we keep controlling the error since the run goes on after it
+			if (!currentParams.isStepping || clampTime == endTime)
+			{
+				//Update table size to max to hope for better convergence since we don't control dt anymore
+				currentTableSize = maxTableSize;
 
-			//Update the last run flag
-			lastRun = true;
+				//Update the last run flag
+				lastRun = true;
+			}
 		}
 
 		//Exit further processing
@@ -289,16 +592,38 @@ const bool OdeSolver::updateDt(OdeSolverParams& currentParams, const bool firstP
 /// <param name="beginTime"></param>
 /// <param name="endTime"></param>
 /// <param name="nodes"></param>
-void OdeSolver::run(const OdeFunIF* problem, crvec initalConditions, const double beginTime, const double endTime)
+void OdeSolver::run(const OdeFunIF* problem, crvec initalConditions, const double beginTime, const double endTime, const CancellationToken& token, const double maxWallTime)
 {
+	//Let the cheapest method do the run if asked to
+	if (generalParams.autoSelect)
+	{
+		runAutoSelect(problem, initalConditions, beginTime, endTime, token, maxWallTime);
+		return;
+	}
+
 	//Prepare to reinitalize everything
 	const OdeSolverParams currentParamsForAllMethods = generalParams;
 
 	//Reset all before starting
 	refreshParams(currentParamsForAllMethods);
 
-	//Initalize all the methods
-	methods.updateAll(initalConditions, generalParams.minTableSize, generalParams.redutionFactor, generalParams.dt);
+	//Make sure the tolerances line up with the state
+	if (!generalParams.checkTolerances(initalConditions.size()))
+	{
+		throw invalid_argument("Tolerances do not match the state size");
+	}
+
+	//Start counting this runs memory
+	markMemory();
+
+	//Initalize all the methods (pinned method threads allocate their own on their node)
+	if (generalParams.threadPlacement == ThreadAffinity::PLACEMENT::NONE)
+	{
+		methods.updateAll(initalConditions, generalParams.maxTableSize, generalParams.redutionFactor, generalParams.dt);
+	}
+
+	//Pick where each method starts
+	startMethods(problem, initalConditions, beginTime, endTime);
 
 	//Get the method map
 	methodMap& allowedMethods = methods.getMethodMap();
@@ -313,6 +638,20 @@ void OdeSolver::run(const OdeFunIF* problem, crvec initalConditions, const doubl
 		//Clear out our threads from the previous run
 		methodThreads.clear();
 
+		//Start a fresh monitor for this run watching the callers token and deadline
+		runMonitor = std::make_unique<RunMonitor>(token, maxWallTime);
+
+		//Let the observer know we are starting
+		if (stepObserver != nullptr)
+		{
+			vector<unsigned int> methodIds;
+			for (methodMap::const_iterator methodItr = allowedMethods.cbegin(); methodItr != allowedMethods.cend(); ++methodItr)
+			{
+				methodIds.push_back(methodItr->first);
+			}
+			stepObserver->runStarted(beginTime, endTime, methodIds);
+		}
+
 		//Iterate over all the methods
 		for (methodMap::iterator methodItr = allowedMethods.begin(); methodItr != allowedMethods.end(); ++methodItr)
 		{
@@ -325,6 +664,9 @@ void OdeSolver::run(const OdeFunIF* problem, crvec initalConditions, const doubl
 			//Get the current richardson parameters
 			Richardson& currentTables = methods.getTableMap().find(methodItr->first)->second;
 
+			//Get the current methods scratch arena
+			MethodArena& currentArena = methods.getArenaMap().find(methodItr->first)->second;
+
 			//Get the current problems result map
 			vector<StateVector>& currentStateVector = resultMap.find(methodItr->first)->second;
 
@@ -336,6 +678,7 @@ void OdeSolver::run(const OdeFunIF* problem, crvec initalConditions, const doubl
 				std::ref(currentMethod),
 				std::ref(currentParams),
 				std::ref(currentTables),
+				std::ref(currentArena),
 				beginTime, 
 				endTime, 
 				std::cref(initalConditions), 
@@ -343,151 +686,463 @@ void OdeSolver::run(const OdeFunIF* problem, crvec initalConditions, const doubl
 				std::ref(currentStateVector))));
 		}
 
-		//Initalize our status checkup
-		bool allowedCheckup = true;
-
-		//Keep running to check the status of everyone
-		while (allowedCheckup)
+		//Join all the threads to get the results
+		for (vector<thread>::iterator threadItr = methodThreads.begin(); threadItr != methodThreads.end(); ++threadItr)
 		{
-			//Counter to ensure we are all finished
-			short int counter = 0;
-
-			//Lock our thread if we are going to look at data
-			mutex lock;
-
-			//Lock
-			lock.lock();
-
-			//Get the status of the method
-			for (map<unsigned int, unique_ptr<SolverIF>>::const_iterator methodItr = allowedMethods.cbegin(); methodItr != allowedMethods.cend(); ++methodItr)
-			{
-				//Get the params for this method to check its current time
-				const OdeSolverParams& currentParams = params.find(methodItr->first)->second;
-
-				//Compute calculations to print to terminal
-				const double percentDone = 100 * std::fabs((currentParams.currentTime - beginTime) / (endTime - beginTime));
-				const double remainingTime = (currentParams.totalTime / (.01 * percentDone)) * (endTime - currentParams.currentTime);
-
-				//Print our the current percentage done to terminal
-				std::cout << std::setprecision(4) << std::setw(2) << "{" << methodItr->first << ":\t" << "CurrentTime: " << currentParams.currentTime << "; " << percentDone << "% Done; Remaining Time: "
-					<< std::max(remainingTime, 0.0) << "; TotalError: "<< currentParams.totalError << "; Step Size: " << currentParams.dt << "; NumLevels: " << currentParams.currentTableSize << "}" << std::endl;
+			threadItr->join();
+		}
 
-				//Update if we should continue sampling
-				counter += static_cast<short int>(currentParams.lastRun);
-			}
+		//Keep what the methods learned for the next run
+		saveWarmStart();
+		collectMemory();
 
-			//check out counter
-			if (counter == allowedMethods.size())
+		//Tell the observer where everyone ended up
+		if (stepObserver != nullptr)
+		{
+			map<unsigned int, ProgressRecord> finalRecords;
+			for (paramMap::const_iterator paramItr = params.cbegin(); paramItr != params.cend(); ++paramItr)
 			{
-				//Break loop
-				allowedCheckup = false;
+				finalRecords[paramItr->first] = progressSlots.find(paramItr->first)->second->read();
 			}
-
-			//Unlock
-			lock.unlock();
-
-			//Delay our sampling time
-			std::this_thread::sleep_for(std::chrono::seconds(2));
-		}
-
-		//Join all the threads to get the results
-		for (vector<thread>::iterator threadItr = methodThreads.begin(); threadItr != methodThreads.end(); ++threadItr)
-		{
-			threadItr->join();
+			stepObserver->runCompleted(finalRecords);
 		}
 	}
 }
 
 /// <summary>
-/// When the object is already initalized and we want to update the parameters for another run we clear out our maps
-/// and rebuild the methods with the new parameters
+/// This runs every inital condition of the ensemble for all methods.
+/// The members are packed into one structure of arrays state so each method steps all of them in lockstep on its own thread.
 /// </summary>
-/// <param name="paramsIn"></param>
-void OdeSolver::refreshParams(const OdeSolverParams& paramsIn)
+/// <param name="problem"></param>
+/// <param name="initalConditions"></param>
+/// <param name="beginTime"></param>
+/// <param name="endTime"></param>
+void OdeSolver::runEnsemble(const OdeFunIF* problem, const vector<vec>& initalConditions, const double beginTime, const double endTime)
 {
-	//Cleaar our methods
-	methods.clearMethods();
+	//Prepare to reinitalize everything
+	const OdeSolverParams currentParamsForAllMethods = generalParams;
 
-	//Clear out our method parameters
-	params.clear();
+	//Reset all before starting
+	refreshParams(currentParamsForAllMethods);
 
-	//Clear out our results
-	resultMap.clear();
+	//Pack all our members
+	const EnsembleState packedConditions(initalConditions);
 
-	//Clear out our vector of threads
-	methodThreads.clear();
+	//Make sure the tolerances line up with each member
+	if (!generalParams.checkTolerances(packedConditions.getComponents()))
+	{
+		throw invalid_argument("Tolerances do not match the state size");
+	}
 
-	//ReInitaize our general parameters
-	generalParams = paramsIn;
+	//Initalize all the methods for the packed size
+	methods.updateAll(packedConditions.getPackedState(), generalParams.maxTableSize, generalParams.redutionFactor, generalParams.dt);
 
-	//Set up everything again
-	setup();
-}
+	//Get the method map
+	methodMap& allowedMethods = methods.getMethodMap();
 
-/// <summary>
-/// /// Return the results for a known enum Solver Type for the method. 
-/// We return the entire vector of solutions.
-/// </summary>
-/// <param name="methodType"></param>
-/// <returns></returns>
-const vector<StateVector>& OdeSolver::getResults(SolverIF::SOLVER_TYPES methodType) const
-{
-	//Get the method Id
-	unsigned int methodId = static_cast<unsigned int>(methodType);
+	//Check if we have avaiable methods
+	if (allowedMethods.empty())
+	{
+		throw runtime_error("No Allowed Methods Available");
+	}
 
-	//Check if the method type being asked is in our map
-	map<unsigned int, vector<StateVector>>::const_iterator result = resultMap.find(methodId);
+	//Clear out our threads from the previous run
+	methodThreads.clear();
 
-	//If result is not found
-	if (result == resultMap.cend())
+	//Iterate over all the methods
+	for (methodMap::iterator methodItr = allowedMethods.begin(); methodItr != allowedMethods.end(); ++methodItr)
 	{
-		throw invalid_argument("Invalid Method");
+		//Only explict methods support ensembles
+		if (!isExplict(methodItr->first))
+		{
+			throw logic_error("Ensembles Not Implimented For Implict Schemes");
+		}
+
+		//Get the current parameters associated with the method
+		const OdeSolverParams& currentParams = params.find(methodItr->first)->second;
+
+		//Get the current richardson parameters
+		Richardson& currentTables = methods.getTableMap().find(methodItr->first)->second;
+
+		//Get the current methods scratch
+		MethodArena& currentArena = methods.getArenaMap().find(methodItr->first)->second;
+
+		//Get the current methods ensemble results
+		ensembleNode& currentEnsembleResults = ensembleResultMap.find(methodItr->first)->second;
+
+		//Put back the time iterations
+		methodThreads.push_back(std::move(thread(
+			&OdeSolver::updateNextEnsembleStep,
+			this,
+			methodItr->first,
+			std::ref(methodItr->second),
+			std::cref(currentParams),
+			std::ref(currentTables),
+			std::ref(currentArena),
+			beginTime,
+			endTime,
+			std::cref(packedConditions.getPackedState()),
+			packedConditions.getMembers(),
+			problem,
+			std::ref(currentEnsembleResults))));
 	}
 
-	//Return our vector
-	return result->second;
+	//Join all the threads to get the results
+	for (vector<thread>::iterator threadItr = methodThreads.begin(); threadItr != methodThreads.end(); ++threadItr)
+	{
+		threadItr->join();
+	}
 }
 
 /// <summary>
-/// Return the results for a known enum value for the method. 
-/// We return the entire vector of solutions.
+/// Step every ensemble member to the end time. Each member has its own parameters so it keeps its own dt, table size, and error.
+/// Members that reach the end time are masked out so they no longer cost function evaluations.
 /// </summary>
 /// <param name="methodId"></param>
-/// <returns></returns>
-const vector<StateVector>& OdeSolver::getResults(const unsigned int methodId) const
+/// <param name="currentMethod"></param>
+/// <param name="methodParameters"></param>
+/// <param name="currentTables"></param>
+/// <param name="arena"></param>
+/// <param name="beginTime"></param>
+/// <param name="endTime"></param>
+/// <param name="packedConditions"></param>
+/// <param name="members"></param>
+/// <param name="problem"></param>
+/// <param name="results"></param>
+void OdeSolver::updateNextEnsembleStep(const unsigned int methodId, unique_ptr<SolverIF>& currentMethod, const OdeSolverParams& methodParameters, Richardson& currentTables, MethodArena& arena,
+	const double beginTime, const double endTime, crvec packedConditions, const size_t members, const OdeFunIF* problem, ensembleNode& results)
 {
-	//Check if the method type being asked is in our map
-	map<unsigned int, vector<StateVector>>::const_iterator result = resultMap.find(methodId);
+	//Count what this thread allocates under our method, as stage scratch unless a narrower scope says otherwise
+	MemoryScope memoryScope(MemoryTracker::CATEGORIES::STAGES, methodId);
 
-	//If result is not found
-	if (result == resultMap.cend())
+	//Each member gets its own copy of the parameters
+	vector<OdeSolverParams> memberParams(members, methodParameters);
+
+	//Each members current time
+	timeVec memberTimes(beginTime, members);
+
+	//Members still moving towards the end time
+	maskVec active(beginTime < endTime, members);
+
+	//Our packed current states
+	vec currentStates = packedConditions;
+
+	//Scratch to pull out one member
+	vec& memberState = arena.getBuffer(MethodArena::ARENA_BUFFERS::MEMBER_STATE, packedConditions.size() / members);
+
+	try
 	{
-		throw invalid_argument("Invalid Method");
-	}
+		//Set up a result vector for each member and add the inital states
+		{
+			MemoryScope resultScope(MemoryTracker::CATEGORIES::RESULTS);
+			results.assign(members, vector<StateVector>());
+			for (size_t member = 0; member < members; ++member)
+			{
+				memberParams[member].currentTime = beginTime;
+				EnsembleState::getMember(currentStates, members, member, memberState);
+				results[member].push_back(StateVector(memberState, memberParams[member]));
+			}
+		}
 
-	//Return our vector
-	return result->second;
+		//Keep going until every member is finished
+		while (std::any_of(std::begin(active), std::end(active), [](const bool isActive) { return isActive; }))
+		{
+			//Move the active members to their next time step
+			buildEnsembleSolution(currentMethod, currentTables, arena, memberParams, currentStates, memberTimes, active, problem, endTime);
+
+			//Update each active member's time and save its result
+			for (size_t member = 0; member < members; ++member)
+			{
+				if (!active[member])
+				{
+					continue;
+				}
+
+				//Update the time
+				memberTimes[member] += memberParams[member].dt;
+				memberParams[member].currentTime = memberTimes[member];
+
+				//Push back the result
+				EnsembleState::getMember(currentStates, members, member, memberState);
+				MemoryScope resultScope(MemoryTracker::CATEGORIES::RESULTS);
+				results[member].push_back(StateVector(memberState, memberParams[member]));
+
+				//Mask out the member once it is finished
+				active[member] = memberTimes[member] < endTime;
+			}
+		}
+	}
+	catch (exception& e)
+	{
+		//Print our error and exit the program
+		cerr << e.what();
+		exit(1);
+	}
 }
 
 /// <summary>
-/// This method will find the "best" / lowest error method and return the vector of all results.
+/// Runs one step for every active member. The table size used is the largest any pending member wants.
+/// After each pass the members that satisfy their error are accepted and masked out, the others try again with their new dt.
 /// </summary>
-/// <returns></returns>
-const vector<StateVector>& OdeSolver::getResults() const
+/// <param name="currentMethod"></param>
+/// <param name="currentTable"></param>
+/// <param name="arena"></param>
+/// <param name="memberParams"></param>
+/// <param name="currentStates"></param>
+/// <param name="memberTimes"></param>
+/// <param name="active"></param>
+/// <param name="problem"></param>
+/// <param name="endTime"></param>
+void OdeSolver::buildEnsembleSolution(unique_ptr<SolverIF>& currentMethod, Richardson& currentTable, MethodArena& arena, vector<OdeSolverParams>& memberParams,
+	rvec currentStates, const timeVec& memberTimes, const maskVec& active, const OdeFunIF* problem, const double endTime)
 {
-	//check if we even ran any solvers
-	if (resultMap.empty())
+	//Number of members
+	const size_t members = memberParams.size();
+
+	//Scratch for the updated states, each members dt, and each members error from our arena so steady state steps do not allocate
+	vec& newStates = arena.getBuffer(MethodArena::ARENA_BUFFERS::NEW_STATE, currentStates.size());
+	timeVec& memberDts = arena.getTimeBuffer(MethodArena::TIME_BUFFERS::MEMBER_DTS, members);
+	accVec& memberErrors = arena.getMemberErrors(members);
+	vec& memberState = arena.getBuffer(MethodArena::ARENA_BUFFERS::MEMBER_STATE, currentStates.size() / members);
+	memberDts = 0.0;
+	memberErrors = 0.0;
+
+	//Members still searching for their dt
+	maskVec& pending = arena.getPendingMask(members);
+	pending = active;
+
+	//Set up each active member like a single run would
+	for (size_t member = 0; member < members; ++member)
 	{
-		throw runtime_error("No method's results saved");
+		if (!pending[member])
+		{
+			continue;
+		}
+
+		//Reset the satisfaction criteria
+		memberParams[member].satifiesError = false;
+
+		//Set our inital convergence criterial the the theoretical local truncation error 
+		memberParams[member].c = currentMethod->getErrorOrder() + static_cast<double>(memberParams[member].minTableSize);
+
+		//Update dt with our convergence criteria
+		updateDt(memberParams[member], true, memberTimes[member], endTime);
 	}
 
-	//Find the best result (smallest error)
-	map<unsigned int, vector<StateVector>>::const_iterator bestResult = std::min_element(resultMap.cbegin(), resultMap.cend(),
-		[](const std::pair<unsigned int, vector<StateVector>>& leftMap, const std::pair<unsigned int, vector<StateVector>>& rightMap)
+	//Measure the error with the norm and tolerances asked for, repeated over the packed members
+	currentTable.setErrorNorm(memberParams.front(), members);
+
+	//Get the current time
+	std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+
+	//Run until every member is accepted
+	while (std::any_of(std::begin(pending), std::end(pending), [](const bool isPending) { return isPending; }))
+	{
+		//Use the largest table any pending member wants
+		size_t tableSize = 0;
+		for (size_t member = 0; member < members; ++member)
 		{
-			//Get the max total error at the end
-			return leftMap.second.back().getParams().totalError < rightMap.second.back().getParams().totalError;
-		});
+			memberDts[member] = pending[member] ? memberParams[member].dt : 0.0;
+			tableSize = pending[member] ? std::max(tableSize, memberParams[member].currentTableSize) : tableSize;
+		}
+
+		//Update our table
+		currentTable.initalizeSteps(memberParams.front().redutionFactor, memberDts.max());
+
+		//Update the Richardson Table Size
+		{
+			MemoryScope tableScope(MemoryTracker::CATEGORIES::TABLES);
+			currentTable.BuildTables(tableSize, currentStates.size());
+		}
+
+		//Run our method for the pending members
+		runEnsembleMethod(problem, currentMethod, currentTable, arena, currentStates, newStates, memberDts, memberTimes, pending);
+
+		//Extrapolate all members at once and split the error up by member
+		double c = 0.0;
+		currentTable.error(newStates, c);
+		currentTable.memberErrors(memberErrors, members);
+
+		//Check each pending member
+		for (size_t member = 0; member < members; ++member)
+		{
+			if (!pending[member])
+			{
+				continue;
+			}
+
+			//Update the results with the new error
+			OdeSolverParams& currentParams = memberParams[member];
+			currentParams.currentError = memberErrors[member];
+			currentParams.c = std::abs(std::log(currentParams.currentError) / std::log(currentParams.dt));
+
+			//Accept the member and mask it out if it converged
+			if (!updateDt(currentParams, false, memberTimes[member], endTime))
+			{
+				EnsembleState::getMember(newStates, members, member, memberState);
+				EnsembleState::setMember(currentStates, members, member, memberState);
+				pending[member] = false;
+			}
+		}
+	}
+
+	//Get the second time point
+	std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
+
+	//Save the duriation of time to each member we moved
+	const double runTime = std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1).count();
+	for (size_t member = 0; member < members; ++member)
+	{
+		if (active[member])
+		{
+			memberParams[member].currentRunTime = runTime;
+			memberParams[member].totalTime += runTime;
+		}
+	}
+}
+
+/// <summary>
+/// Build up the richardson tables for every pending member at once. Each row divides each members dt by the reduction factor.
+/// </summary>
+/// <param name="problem"></param>
+/// <param name="method"></param>
+/// <param name="tables"></param>
+/// <param name="arena"></param>
+/// <param name="initalConditions"></param>
+/// <param name="newStates"></param>
+/// <param name="memberDts"></param>
+/// <param name="memberTimes"></param>
+/// <param name="pending"></param>
+void OdeSolver::runEnsembleMethod(const OdeFunIF* problem, unique_ptr<SolverIF>& method, Richardson& tables, MethodArena& arena, crvec initalConditions, rvec newStates, const timeVec& memberDts, const timeVec& memberTimes, const maskVec& pending)
+{
+	//Scratch for each members dt on a row
+	timeVec& stepDts = arena.getTimeBuffer(MethodArena::TIME_BUFFERS::STEP_DTS, memberDts.size());
+
+	//Loop over all the tables
+	for (unsigned int i = 0; i < tables.getTableSize(); ++i)
+	{
+		//Number of steps for this row
+		const double steps = pow(tables.getReductionFactor(), static_cast<double>(i));
+
+		//Split each members dt over the row without building a temporary
+		for (size_t member = 0; member < memberDts.size(); ++member)
+		{
+			stepDts[member] = memberDts[member] / steps;
+		}
+
+		//Solve for the next time step of every pending member
+		method->update(initalConditions, newStates, stepDts, memberTimes, static_cast<int>(steps), pending, problem);
+
+		//Add the result into the tables
+		tables.append(i, 0, newStates);
+	}
+}
+
+/// <summary>
+/// When the object is already initalized and we want to update the parameters for another run we clear out our maps
+/// and rebuild the methods with the new parameters
+/// </summary>
+/// <param name="paramsIn"></param>
+void OdeSolver::refreshParams(const OdeSolverParams& paramsIn)
+{
+	//Cleaar our methods
+	methods.clearMethods();
+
+	//Clear out our method parameters
+	params.clear();
+
+	//Clear out our results
+	resultMap.clear();
+
+	//Clear out our ensemble results
+	ensembleResultMap.clear();
+
+	//Start our progress over in place (the slots stay put for anyone reading them) and clear our counters
+	for (map<unsigned int, unique_ptr<ProgressSlot>>::const_iterator slotItr = progressSlots.cbegin(); slotItr != progressSlots.cend(); ++slotItr)
+	{
+		slotItr->second->reset();
+	}
+	statsMap.clear();
+	replayPositions.clear();
+
+	//Clear out our vector of threads
+	methodThreads.clear();
+
+	//Drop the monitor of the previous run
+	runMonitor.reset();
+
+	//Drop any stepping session
+	stepperProblem = nullptr;
+
+	//Clear out our auto selections
+	selectionHistory.clear();
+
+	//ReInitaize our general parameters
+	generalParams = paramsIn;
+
+	//Set up everything again
+	setup();
+}
+
+/// <summary>
+/// /// Return the results for a known enum Solver Type for the method. 
+/// We return the entire vector of solutions.
+/// </summary>
+/// <param name="methodType"></param>
+/// <returns></returns>
+const vector<StateVector>& OdeSolver::getResults(SolverIF::SOLVER_TYPES methodType) const
+{
+	//Get the method Id
+	unsigned int methodId = static_cast<unsigned int>(methodType);
+
+	//Check if the method type being asked is in our map
+	map<unsigned int, vector<StateVector>>::const_iterator result = resultMap.find(methodId);
+
+	//If result is not found
+	if (result == resultMap.cend())
+	{
+		throw invalid_argument("Invalid Method");
+	}
+
+	//Return our vector
+	return result->second;
+}
+
+/// <summary>
+/// Return the results for a known enum value for the method. 
+/// We return the entire vector of solutions.
+/// </summary>
+/// <param name="methodId"></param>
+/// <returns></returns>
+const vector<StateVector>& OdeSolver::getResults(const unsigned int methodId) const
+{
+	//Check if the method type being asked is in our map
+	map<unsigned int, vector<StateVector>>::const_iterator result = resultMap.find(methodId);
+
+	//If result is not found
+	if (result == resultMap.cend())
+	{
+		throw invalid_argument("Invalid Method");
+	}
+
+	//Return our vector
+	return result->second;
+}
+
+/// <summary>
+/// This method will find the "best" / lowest error method and return the vector of all results.
+/// </summary>
+/// <returns></returns>
+const vector<StateVector>& OdeSolver::getResults() const
+{
+	//check if we even ran any solvers
+	if (resultMap.empty())
+	{
+		throw runtime_error("No method's results saved");
+	}
+
+	//Find the best result (smallest error)
+	map<unsigned int, vector<StateVector>>::const_iterator bestResult = findBestResults();
 	
 	//Check to see if our results are valid
 	if (bestResult == resultMap.cend())
@@ -538,88 +1193,98 @@ const StateVector OdeSolver::getStateAndTime(const unsigned int methodId, const
 	//Start searching for the conditions
 	else
 	{
-		//Get a handle to our current results
-		const vector<StateVector>& currentResults = currentMethod->second;
+		//Interpolate the results for this method
+		return interpolateResults(currentMethod->second, time);
+	}
+}
 
-		//Check if we need to clamp our results if a time is outside our bounds
-		if (currentResults.back().getParams().currentTime <= time)
-		{
-			return StateVector(currentResults.back().getState(), currentResults.back().getParams());
-		}
-		else if (currentResults.at(0).getParams().currentTime >= time)
-		{
-			return StateVector(currentResults.at(0).getState(), currentResults.at(0).getParams());
-		}
-		//We do not need to clamp
-		else
-		{
-			//This is the iterator to hold the state vector before we pass
-			vector<StateVector>::const_iterator beforePassResult;
+/// <summary>
+/// Clamp the results if the time is out of bounds. Otherwise find the results on either side of the time and linearly interpolate
+/// the state and the errors to build a new state vector.
+/// </summary>
+/// <param name="currentResults"></param>
+/// <param name="time"></param>
+/// <returns></returns>
+const StateVector OdeSolver::interpolateResults(const vector<StateVector>& currentResults, const double time)
+{
+	//Check if we need to clamp our results if a time is outside our bounds
+	if (currentResults.back().getParams().currentTime <= time)
+	{
+		return StateVector(currentResults.back().getState(), currentResults.back().getParams());
+	}
+	else if (currentResults.at(0).getParams().currentTime >= time)
+	{
+		return StateVector(currentResults.at(0).getState(), currentResults.at(0).getParams());
+	}
+	//We do not need to clamp
+	else
+	{
+		//This is the iterator to hold the state vector before we pass
+		vector<StateVector>::const_iterator beforePassResult;
 
-			//This is the iterator to hold the state vector just after we pass
-			vector<StateVector>::const_reverse_iterator afterPassResult;
+		//This is the iterator to hold the state vector just after we pass
+		vector<StateVector>::const_reverse_iterator afterPassResult;
 
-			//Find the place after after the reqested time
-			beforePassResult = std::find_if(currentResults.cbegin(), currentResults.cend(), [&time](const StateVector& s) {return s.getParams().currentTime > time; });
+		//Find the place after after the reqested time
+		beforePassResult = std::find_if(currentResults.cbegin(), currentResults.cend(), [&time](const StateVector& s) {return s.getParams().currentTime > time; });
 
-			//Find the place before after the reqested time
-			afterPassResult = std::find_if(currentResults.crbegin(), currentResults.crend(), [&time](const StateVector& s) {return s.getParams().currentTime <= time; });
+		//Find the place before after the reqested time
+		afterPassResult = std::find_if(currentResults.crbegin(), currentResults.crend(), [&time](const StateVector& s) {return s.getParams().currentTime <= time; });
 
-			//Check if we can find our current result
-			if (afterPassResult == currentResults.crend() || beforePassResult == currentResults.cend())
-			{
-				throw invalid_argument("Invalid Time given");
-			}
-			else
-			{
-				//Get each found iterators corresponding times
-				const double& leftTime = afterPassResult->getParams().currentTime;
-				const double& rightTime = beforePassResult->getParams().currentTime;
+		//Check if we can find our current result
+		if (afterPassResult == currentResults.crend() || beforePassResult == currentResults.cend())
+		{
+			throw invalid_argument("Invalid Time given");
+		}
+		else
+		{
+			//Get each found iterators corresponding times
+			const double& leftTime = afterPassResult->getParams().currentTime;
+			const double& rightTime = beforePassResult->getParams().currentTime;
 
-				//Get each found iterators corresponding state
-				const valarray<double>& leftState = afterPassResult->getState();
-				const valarray<double>& rightState = beforePassResult->getState();
+			//Get each found iterators corresponding state
+			const vec& leftState = afterPassResult->getState();
+			const vec& rightState = beforePassResult->getState();
 
-				//Get the error found on the left and right
-				const double& leftError = afterPassResult->getParams().totalError;
-				const double& rightError = beforePassResult->getParams().totalError;
+			//Get the error found on the left and right
+			const double& leftError = afterPassResult->getParams().totalError;
+			const double& rightError = beforePassResult->getParams().totalError;
 
-				//Get the local truncation error
-				const double& leftTrunkError = afterPassResult->getParams().currentError;
-				const double& rightTrunkError = beforePassResult->getParams().currentError;
+			//Get the local truncation error
+			const double& leftTrunkError = afterPassResult->getParams().currentError;
+			const double& rightTrunkError = beforePassResult->getParams().currentError;
 
-				//Get the runtime
-				const double& leftRuntime = afterPassResult->getParams().currentRunTime;
-				const double& rightRuntime = beforePassResult->getParams().currentRunTime;
+			//Get the runtime
+			const double& leftRuntime = afterPassResult->getParams().currentRunTime;
+			const double& rightRuntime = beforePassResult->getParams().currentRunTime;
 
-				//Copy over the parameters found
-				OdeSolverParams tempParams = afterPassResult->getParams();
+			//Copy over the parameters found
+			OdeSolverParams tempParams = afterPassResult->getParams();
 
-				//Copy over the desired time to our parameters
-				tempParams.currentTime = time;
+			//Copy over the desired time to our parameters
+			tempParams.currentTime = time;
 
-				//Build the interpolated state
-				valarray<double> intpState = leftState * (1.0 - ((time - leftTime) / (rightTime - leftTime))) +
-					rightState * ((time - leftTime) / (rightTime - leftTime));
+			//Build the interpolated state
+			vec intpState = leftState * static_cast<scalar>(1.0 - ((time - leftTime) / (rightTime - leftTime))) +
+				rightState * static_cast<scalar>((time - leftTime) / (rightTime - leftTime));
 
-				//Build the interpolated total error
-				tempParams.totalError = leftError * (1.0 - ((time - leftTime) / (rightTime - leftTime))) +
-					rightError * ((time - leftTime) / (rightTime - leftTime));
+			//Build the interpolated total error
+			tempParams.totalError = leftError * (1.0 - ((time - leftTime) / (rightTime - leftTime))) +
+				rightError * ((time - leftTime) / (rightTime - leftTime));
 
-				//Build the interpolated truncation error
-				tempParams.currentError = leftTrunkError * (1.0 - ((time - leftTime) / (rightTime - leftTime))) +
-					rightTrunkError * ((time - leftTime) / (rightTime - leftTime));
+			//Build the interpolated truncation error
+			tempParams.currentError = leftTrunkError * (1.0 - ((time - leftTime) / (rightTime - leftTime))) +
+				rightTrunkError * ((time - leftTime) / (rightTime - leftTime));
 
-				//Build the interpolated run time
-				tempParams.currentRunTime = leftRuntime * (1.0 - ((time - leftTime) / (rightTime - leftTime))) +
-					rightRuntime * ((time - leftTime) / (rightTime - leftTime));
+			//Build the interpolated run time
+			tempParams.currentRunTime = leftRuntime * (1.0 - ((time - leftTime) / (rightTime - leftTime))) +
+				rightRuntime * ((time - leftTime) / (rightTime - leftTime));
 
-				//Update the params and our new state 
-				StateVector newState(std::move(intpState), std::move(tempParams));
+			//Update the params and our new state 
+			StateVector newState(std::move(intpState), std::move(tempParams));
 
-				//Return our result
-				return newState;
-			}
+			//Return our result
+			return newState;
 		}
 	}
 }
@@ -638,12 +1303,7 @@ const StateVector OdeSolver::getStateAndTime(const double time) const
 	}
 
 	//Find the best result (smallest error)
-	map<unsigned int, vector<StateVector>>::const_iterator bestResult = std::min_element(resultMap.cbegin(), resultMap.cend(), 
-		[](const std::pair<unsigned int, vector<StateVector>>& leftMap, const std::pair<unsigned int, vector<StateVector>>& rightMap)
-		{
-			//Get the max total error at the end
-			return leftMap.second.back().getParams().totalError < rightMap.second.back().getParams().totalError;
-		});
+	map<unsigned int, vector<StateVector>>::const_iterator bestResult = findBestResults();
 
 	//Check to see if our results are valid
 	if (bestResult == resultMap.cend())
@@ -656,93 +1316,275 @@ const StateVector OdeSolver::getStateAndTime(const double time) const
 }
 
 /// <summary>
-/// Build up all our maps for our methods.
-/// If the params given make no sense we throw
-/// If no methods were built we throw an invalid argument error.
+/// Get the number of members in the last ensemble run
 /// </summary>
-void OdeSolver::setup()
+/// <returns></returns>
+const size_t OdeSolver::getEnsembleSize() const
 {
-	//Check the user inputs
-	if (!generalParams.checkUserInputs())
-	{
-		throw invalid_argument("Invalid Ode Parameters");
-		exit(-1);
-	}
+	//Every method solves every member so check the first one
+	return ensembleResultMap.empty() ? 0 : ensembleResultMap.cbegin()->second.size();
+}
 
-	//Build our allowed methods based on the parameter input
-	try
-	{
-		methods.initalize(generalParams);
-	}
-	catch (exception& e)
+/// <summary>
+/// Return the results of one ensemble member for a known enum Solver Type.
+/// </summary>
+/// <param name="methodType"></param>
+/// <param name="member"></param>
+/// <returns></returns>
+const vector<StateVector>& OdeSolver::getEnsembleResults(SolverIF::SOLVER_TYPES methodType, const size_t member) const
+{
+	//Check if the method type being asked is in our map
+	map<unsigned int, ensembleNode>::const_iterator result = ensembleResultMap.find(static_cast<unsigned int>(methodType));
+
+	//If result is not found
+	if (result == ensembleResultMap.cend())
 	{
-		cerr << e.what();
-		exit(1);
+		throw invalid_argument("Invalid Method");
 	}
 
-	//Get the methods allowed
-	const methodMap& allowedMethods = methods.getMethodMap();
-
-	//Check if no methods were created
-	if (allowedMethods.empty())
+	//Check the member was solved
+	if (member >= result->second.size())
 	{
-		throw runtime_error("No valid methods");
-		exit(1);
+		throw invalid_argument("Invalid Ensemble Member");
 	}
-	else
-	{
-		//Iterate through the allowed methods to build the parameter tables and results table
-		for (methodMap::const_iterator methodItr = allowedMethods.cbegin(); methodItr != allowedMethods.cend(); ++methodItr)
-		{
-			//This is the ID/enum for the method
-			const unsigned int methodId = methodItr->first;
-
-			//Add the method id and parameters to our param map
-			params.emplace(methodId, generalParams);
 
-			//set up our result map
-			resultMap.emplace(methodId, vector<StateVector>());
-		}
-	}
+	//Return our vector
+	return result->second[member];
 }
 
 /// <summary>
-/// We set up the time stepping scheme in order to build solutions to the desired time.
-/// It calls on methods to run each method and build up our tables.
-/// After each time step, we append the solution to our results vector.
+/// Return the results of one ensemble member from the method with the lowest error for that member.
 /// </summary>
-/// <param name="methodId"></param>
-/// <param name="currentMethod"></param>
-/// <param name="currentParameters"></param>
-/// <param name="currentTables"></param>
-/// <param name="beginTime"></param>
-/// <param name="endTime"></param>
-/// <param name="initalConditions"></param>
-/// <param name="problem"></param>
-/// <param name="results"></param>
-void OdeSolver::updateNextTimeStep(const unsigned int methodId, unique_ptr<SolverIF>& currentMethod, OdeSolverParams& currentParameters, 
-	Richardson& currentTables, const double beginTime, const double endTime, const valarray<double>& initalConditions, const OdeFunIF* problem, vector<StateVector>& results)
+/// <param name="member"></param>
+/// <returns></returns>
+const vector<StateVector>& OdeSolver::getEnsembleResults(const size_t member) const
 {
-	//Get our lock
-	mutex lock;
-
-	//Lock the thread
-	lock.lock();
-
-	//Get this current methods dt
-	double& dt = currentParameters.dt;
+	return findBestEnsembleResults(member);
+}
 
-	//Unlock
-	lock.unlock();
+/// <summary>
+/// Interpolate one ensemble member of a known enum Solver Type to the desired time.
+/// </summary>
+/// <param name="methodType"></param>
+/// <param name="member"></param>
+/// <param name="time"></param>
+/// <returns></returns>
+const StateVector OdeSolver::getEnsembleStateAndTime(SolverIF::SOLVER_TYPES methodType, const size_t member, const double time) const
+{
+	return interpolateResults(getEnsembleResults(methodType, member), time);
+}
+
+/// <summary>
+/// Interpolate one ensemble member of the best method to the desired time.
+/// </summary>
+/// <param name="member"></param>
+/// <param name="time"></param>
+/// <returns></returns>
+const StateVector OdeSolver::getEnsembleStateAndTime(const size_t member, const double time) const
+{
+	return interpolateResults(findBestEnsembleResults(member), time);
+}
+
+/// <summary>
+/// Find the method with the smallest total error. Methods that stopped before the end time (partial) only win if every method stopped early.
+/// </summary>
+/// <returns></returns>
+map<unsigned int, vector<StateVector>>::const_iterator OdeSolver::findBestResults() const
+{
+	return std::min_element(resultMap.cbegin(), resultMap.cend(),
+		[](const std::pair<const unsigned int, vector<StateVector>>& leftMap, const std::pair<const unsigned int, vector<StateVector>>& rightMap)
+		{
+			//Get if the methods finished
+			const bool leftPartial = leftMap.second.back().getParams().isPartial;
+			const bool rightPartial = rightMap.second.back().getParams().isPartial;
+
+			//Prefer the method that finished
+			if (leftPartial != rightPartial)
+			{
+				return rightPartial;
+			}
+
+			//Get the max total error at the end
+			return leftMap.second.back().getParams().totalError < rightMap.second.back().getParams().totalError;
+		});
+}
+
+/// <summary>
+/// Find the method with the smallest total error for this member. Each member can have a different best method.
+/// </summary>
+/// <param name="member"></param>
+/// <returns></returns>
+const vector<StateVector>& OdeSolver::findBestEnsembleResults(const size_t member) const
+{
+	//Check if we solved this member
+	if (member >= getEnsembleSize())
+	{
+		throw invalid_argument("Invalid Ensemble Member");
+	}
+
+	//Find the best result (smallest error)
+	map<unsigned int, ensembleNode>::const_iterator bestResult = std::min_element(ensembleResultMap.cbegin(), ensembleResultMap.cend(),
+		[&member](const std::pair<const unsigned int, ensembleNode>& leftMap, const std::pair<const unsigned int, ensembleNode>& rightMap)
+		{
+			//Get the max total error at the end
+			return leftMap.second[member].back().getParams().totalError < rightMap.second[member].back().getParams().totalError;
+		});
+
+	//Return our vector
+	return bestResult->second[member];
+}
+
+/// <summary>
+/// Build up all our maps for our methods.
+/// If the params given make no sense we throw
+/// If no methods were built we throw an invalid argument error.
+/// </summary>
+void OdeSolver::setup()
+{
+	//Check the user inputs
+	if (!generalParams.checkUserInputs())
+	{
+		throw invalid_argument("Invalid Ode Parameters");
+		exit(-1);
+	}
+
+	//Build our allowed methods based on the parameter input
+	try
+	{
+		methods.initalize(generalParams);
+	}
+	catch (exception& e)
+	{
+		cerr << e.what();
+		exit(1);
+	}
+
+	//Get the methods allowed
+	const methodMap& allowedMethods = methods.getMethodMap();
+
+	//Check if no methods were created
+	if (allowedMethods.empty())
+	{
+		throw runtime_error("No valid methods");
+		exit(1);
+	}
+	else
+	{
+		//Iterate through the allowed methods to build the parameter tables and results table
+		for (methodMap::const_iterator methodItr = allowedMethods.cbegin(); methodItr != allowedMethods.cend(); ++methodItr)
+		{
+			//This is the ID/enum for the method
+			const unsigned int methodId = methodItr->first;
+
+			//Add the method id and parameters to our param map
+			params.emplace(methodId, generalParams);
+
+			//set up our result map
+			resultMap.emplace(methodId, vector<StateVector>());
+
+			//set up our ensemble result map
+			ensembleResultMap.emplace(methodId, ensembleNode());
+
+			//set up our counters
+			statsMap.emplace(methodId, MethodStats());
+
+			//set up our place in the replayed schedule and room for the steps we record
+			replayPositions.emplace(methodId, ReplayPosition());
+			if (stepRecording != nullptr)
+			{
+				stepRecording->startRecording(methodId);
+			}
+		}
+	}
+}
+
+/// <summary>
+/// Start every method over for another run without rebuilding the methods, tables, or arenas.
+/// Each map keeps its entries and the results keep their capacity, only what a run leaves behind is cleared.
+/// </summary>
+void OdeSolver::resetRun()
+{
+	//Start each method over
+	for (paramMap::iterator paramItr = params.begin(); paramItr != params.end(); ++paramItr)
+	{
+		const unsigned int methodId = paramItr->first;
+
+		//Our parameters, results, and counters start over
+		paramItr->second = generalParams;
+		resultMap.find(methodId)->second.clear();
+		ensembleResultMap.find(methodId)->second.clear();
+		statsMap.find(methodId)->second = MethodStats();
+
+		//Our place in the replayed schedule and the steps we record start over
+		replayPositions.find(methodId)->second = ReplayPosition();
+		if (stepRecording != nullptr)
+		{
+			stepRecording->startRecording(methodId);
+		}
+	}
+
+	//Start our progress over in place
+	for (map<unsigned int, unique_ptr<ProgressSlot>>::const_iterator slotItr = progressSlots.cbegin(); slotItr != progressSlots.cend(); ++slotItr)
+	{
+		slotItr->second->reset();
+	}
+
+	//Clear out what the last run left behind
+	methodThreads.clear();
+	runMonitor.reset();
+	stepperProblem = nullptr;
+	selectionHistory.clear();
+}
+
+/// <summary>
+/// We set up the time stepping scheme in order to build solutions to the desired time.
+/// It calls on methods to run each method and build up our tables.
+/// After each time step, we append the solution to our results vector.
+/// </summary>
+/// <param name="methodId"></param>
+/// <param name="currentMethod"></param>
+/// <param name="currentParameters"></param>
+/// <param name="currentTables"></param>
+/// <param name="arena"></param>
+/// <param name="beginTime"></param>
+/// <param name="endTime"></param>
+/// <param name="initalConditions"></param>
+/// <param name="problem"></param>
+/// <param name="results"></param>
+void OdeSolver::updateNextTimeStep(const unsigned int methodId, unique_ptr<SolverIF>& currentMethod, OdeSolverParams& currentParameters, 
+	Richardson& currentTables, MethodArena& arena, const double beginTime, const double endTime, const vec& initalConditions, const OdeFunIF* problem, vector<StateVector>& results)
+{
+	//Count what this thread allocates under our method, as stage scratch unless a narrower scope says otherwise
+	MemoryScope memoryScope(MemoryTracker::CATEGORIES::STAGES, methodId);
+
+	//Pin ourselves and allocate our vectors, table, and scratch here so they are first touched on our node
+	if (currentParameters.threadPlacement != ThreadAffinity::PLACEMENT::NONE)
+	{
+		ThreadAffinity::pinCurrentThread(currentParameters.threadPlacement, std::distance(params.begin(), params.find(methodId)));
+		methods.updateMethod(methodId, initalConditions, currentParameters.maxTableSize, currentParameters.redutionFactor, currentParameters.dt);
+	}
+
+	//Get our counters and count our right hand side evaluations into them
+	MethodStats& stats = statsMap.find(methodId)->second;
+	const CountingOdeFun countedProblem(problem, stats.rhsEvaluations);
+
+	//Get this current methods dt
+	double& dt = currentParameters.dt;
 
 	//Save our current time
 	double currentTime = beginTime;
 
-	//Save our currentState
-	valarray<double> currentState = initalConditions;
+	//Save our currentState and get the scratch for the next state from our arena
+	vec& currentState = arena.getBuffer(MethodArena::ARENA_BUFFERS::CURRENT_STATE, initalConditions.size());
+	vec& newState = arena.getBuffer(MethodArena::ARENA_BUFFERS::NEW_STATE, initalConditions.size());
+	currentState = initalConditions;
 
-	//Lock
-	lock.lock();
+	//Reserve room for the results we expect so pushing them back does not keep reallocating
+	if (keepStreamedResults || stepQueue == nullptr)
+	{
+		MemoryScope resultScope(MemoryTracker::CATEGORIES::RESULTS);
+		results.reserve(results.size() + std::min(static_cast<size_t>((endTime - beginTime) / dt) + 2, maxReservedResults));
+	}
 
 	//Add the current time to our parameters
 	currentParameters.currentTime = currentTime;
@@ -751,47 +1593,41 @@ void OdeSolver::updateNextTimeStep(const unsigned int methodId, unique_ptr<Solve
 	try
 	{
 		//Add the first result into results
-		results.push_back(std::move(StateVector(currentState, currentParameters)));
+		MemoryScope resultScope(MemoryTracker::CATEGORIES::RESULTS);
+		results.emplace_back(currentState, currentParameters);
+		streamResult(methodId, results);
 	}
 	catch (exception& e)
 	{
-		//Unlock our thread
-		lock.unlock();
-
 		//Result error code and exit further processing
 		std::cerr << e.what();
 		exit(1);
 	}
 
-	//Unlock
-	lock.unlock();
+	//Let everyone see where we start
+	publishProgress(methodId, currentParameters);
 
-	while (currentTime < endTime)
+	//Keep stepping until the end unless another method, the caller, or the deadline asked us to stop
+	while (currentTime < endTime && !runMonitor->isStopRequested())
 	{
 		try
 		{
-			//Lock
-			lock.lock();
-
 			//Solver for the next time step for the current method
-			currentState = buildSolution(currentMethod, methodId, currentTables, currentParameters, currentState, problem, currentTime, endTime);
+			currentState = buildSolution(currentMethod, methodId, currentTables, arena, currentParameters, currentState, newState, &countedProblem, currentTime, endTime);
 
-			//Unlock
-			lock.unlock();
+			//Throw away the step if it was stopped part way through
+			if (currentParameters.isPartial)
+			{
+				break;
+			}
 		}
 		catch (exception& e)
 		{
-			//Unlock
-			lock.unlock();
-
 			//Print our error and exit the program
 			cerr << e.what();
 			exit(1);
 		}
 
-		//Lock
-		lock.lock();
-
 		//Update the time
 		currentTime += dt;
 
@@ -802,40 +1638,931 @@ void OdeSolver::updateNextTimeStep(const unsigned int methodId, unique_ptr<Solve
 		try
 		{
 			//Push back the result
-			results.push_back(std::move(StateVector(currentState, currentParameters)));
+			MemoryScope resultScope(MemoryTracker::CATEGORIES::RESULTS);
+			results.emplace_back(currentState, currentParameters);
+			streamResult(methodId, results);
 		}
 		catch (exception& e)
 		{
-			//Unlock
-			lock.unlock();
-
 			cerr << e.what();
 			exit(1);
 		}
 
-		//Unlock
-		lock.unlock();
+		//Publish the accepted step
+		++stats.acceptedSteps;
+		publishProgress(methodId, currentParameters);
+		if (stepObserver != nullptr)
+		{
+			stepObserver->stepAccepted(methodId, progressSlots.find(methodId)->second->draft());
+		}
+
+		//Check if we are projected to lose the race (taking too long or missing the error) once enough of the interval is done
+		const double progress = (currentTime - beginTime) / (endTime - beginTime);
+		if (currentParameters.isRace && currentParameters.stopProjectedLosers && currentTime < endTime && progress >= minRaceProgress)
+		{
+			//Project the wall time to the end, a method that will miss the error never finishes the race
+			const bool missesError = currentParameters.totalError / progress > currentParameters.upperError;
+			const double projectedTime = missesError ? std::numeric_limits<double>::infinity() : currentParameters.totalTime / progress;
+
+			if (runMonitor->isProjectedToLose(methodId, projectedTime, currentParameters.raceLossFactor))
+			{
+				break;
+			}
+		}
+	}
+
+	//Mark our results if we stopped before the end
+	if (currentTime < endTime)
+	{
+		currentParameters.isPartial = true;
+		results.back().markPartial();
+	}
+
+	//If we won the race stop everyone else
+	if (currentParameters.isRace && !currentParameters.isPartial && currentParameters.satifiesError)
+	{
+		runMonitor->requestStop();
 	}
+
+	//Publish that we are done
+	progressSlots.find(methodId)->second->draft().isFinished = true;
+	publishProgress(methodId, currentParameters);
+
+	//Let the run know we are done
+	runMonitor->methodFinished(methodId);
 }
 
-const bool OdeSolver::isExplict(const unsigned int methodId) const
+/// <summary>
+/// Set up a stepping session. We rebuild everything once here and then keep the states, learned dt, table sizes,
+/// and scratch in the methods parameters and arenas so each advance picks up where the last one left off.
+/// </summary>
+/// <param name="problem"></param>
+/// <param name="initalConditions"></param>
+/// <param name="beginTime"></param>
+/// <param name="endTime"></param>
+void OdeSolver::startStepping(const OdeFunIF* problem, crvec initalConditions, const double beginTime, const double endTime)
 {
-	switch (methodId)
+	//Prepare to reinitalize everything
+	const OdeSolverParams currentParamsForAllMethods = generalParams;
+
+	//Reset all before starting
+	refreshParams(currentParamsForAllMethods);
+
+	//Start each method
+	beginStepping(problem, initalConditions, beginTime, endTime);
+}
+
+/// <summary>
+/// Set up another stepping session with the same parameters. The methods, tables, and arenas built for the last session are kept and
+/// only the parameters, results, and counters of each method start over, so solving many instances does not rebuild everything each time.
+/// Before anything is built this is the same as startStepping.
+/// </summary>
+/// <param name="problem"></param>
+/// <param name="initalConditions"></param>
+/// <param name="beginTime"></param>
+/// <param name="endTime"></param>
+void OdeSolver::restartStepping(const OdeFunIF* problem, crvec initalConditions, const double beginTime, const double endTime)
+{
+	//Nothing built yet so build it all
+	if (params.empty())
 	{
-	case 10:
-	case 20:
-	case 30:
+		startStepping(problem, initalConditions, beginTime, endTime);
+		return;
+	}
+
+	//Start over in place
+	resetRun();
+
+	//Start each method
+	beginStepping(problem, initalConditions, beginTime, endTime);
+}
+
+/// <summary>
+/// Check the inputs and start each method at the inital condition. The methods have to be built already.
+/// Sizing the methods, tables, and arenas only allocates when the state size or table size changed.
+/// </summary>
+/// <param name="problem"></param>
+/// <param name="initalConditions"></param>
+/// <param name="beginTime"></param>
+/// <param name="endTime"></param>
+void OdeSolver::beginStepping(const OdeFunIF* problem, crvec initalConditions, const double beginTime, const double endTime)
+{
+	//Make sure the tolerances line up with the state
+	if (!generalParams.checkTolerances(initalConditions.size()))
 	{
-		return true;
+		throw invalid_argument("Tolerances do not match the state size");
 	}
-	case 40:
-	case 50:
+
+	//Check we have somewhere to step to
+	if (!(endTime > beginTime))
 	{
-		return false;
+		throw invalid_argument("End time must be after the begin time");
 	}
-	default:
+
+	//Initalize all the methods
+	markMemory();
+	methods.updateAll(initalConditions, generalParams.maxTableSize, generalParams.redutionFactor, generalParams.dt);
+
+	//Pick where each method starts
+	startMethods(problem, initalConditions, beginTime, endTime);
+
+	//Save off our problem and horizon
+	stepperProblem = problem;
+	stepperEndTime = endTime;
+
+	//Start each method at the inital condition
+	for (paramMap::iterator paramItr = params.begin(); paramItr != params.end(); ++paramItr)
 	{
-		throw std::invalid_argument("Method Id not found");
+		//Get the current parameters and scratch arena
+		OdeSolverParams& currentParams = paramItr->second;
+		MethodArena& currentArena = methods.getArenaMap().find(paramItr->first)->second;
+
+		//Slices do not end the run
+		currentParams.isStepping = true;
+		currentParams.currentTime = beginTime;
+
+		//Save our current state in the arena
+		currentArena.getBuffer(MethodArena::ARENA_BUFFERS::CURRENT_STATE, initalConditions.size()) = initalConditions;
+
+		//Add the first result
+		MemoryScope resultScope(MemoryTracker::CATEGORIES::RESULTS, paramItr->first);
+		resultMap.find(paramItr->first)->second.emplace_back(initalConditions, currentParams);
+	}
+}
+
+/// <summary>
+/// Advance every method to the time. The last step of each method is shortened to land on the time.
+/// </summary>
+/// <param name="time"></param>
+void OdeSolver::advanceTo(const double time)
+{
+	//Check we are stepping and not going past our horizon
+	if (stepperProblem == nullptr)
+	{
+		throw logic_error("Stepping has not been started");
+	}
+	if (time > stepperEndTime)
+	{
+		throw invalid_argument("Can not advance past the end time");
+	}
+
+	stepAllMethodsTo(time, std::numeric_limits<size_t>::max());
+	saveWarmStart();
+	collectMemory();
+}
+
+/// <summary>
+/// Take one accepted step with every method toward the end time
+/// </summary>
+void OdeSolver::step()
+{
+	//Check we are stepping
+	if (stepperProblem == nullptr)
+	{
+		throw logic_error("Stepping has not been started");
+	}
+
+	stepAllMethodsTo(stepperEndTime, 1);
+
+	//A real time step does not allocate so it leaves saving the warm start to advanceTo
+	if (!generalParams.realTime)
+	{
+		saveWarmStart();
+	}
+	collectMemory();
+}
+
+/// <summary>
+/// Get the earliest time any method has reached while stepping
+/// </summary>
+/// <returns></returns>
+const double OdeSolver::getCurrentTime() const
+{
+	//check if we even have any methods
+	if (params.empty())
+	{
+		throw runtime_error("No methods available");
 	}
+
+	double currentTime = std::numeric_limits<double>::infinity();
+	for (const auto& currentParams : params)
+	{
+		currentTime = std::min(currentTime, currentParams.second.currentTime);
 	}
-}
\ No newline at end of file
+
+	return currentTime;
+}
+
+/// <summary>
+/// Step every method toward the slice end. With one method we stay on the callers thread so short slices do not pay for a thread.
+/// </summary>
+/// <param name="sliceEnd"></param>
+/// <param name="maxSteps"></param>
+void OdeSolver::stepAllMethodsTo(const double sliceEnd, const size_t maxSteps)
+{
+	//Check if we have avaiable methods
+	if (params.empty())
+	{
+		throw runtime_error("No Allowed Methods Available");
+	}
+
+	//Run a single method in place
+	if (params.size() == 1)
+	{
+		stepMethodTo(params.begin()->first, sliceEnd, maxSteps);
+		return;
+	}
+
+	//Clear out our threads from the previous slice
+	methodThreads.clear();
+
+	//Step each method on its own thread
+	for (paramMap::const_iterator paramItr = params.cbegin(); paramItr != params.cend(); ++paramItr)
+	{
+		methodThreads.push_back(thread(&OdeSolver::stepMethodTo, this, paramItr->first, sliceEnd, maxSteps));
+	}
+
+	//Join all the threads to get the results
+	for (vector<thread>::iterator threadItr = methodThreads.begin(); threadItr != methodThreads.end(); ++threadItr)
+	{
+		threadItr->join();
+	}
+}
+
+/// <summary>
+/// Take accepted steps with one method from its current time toward the slice end.
+/// If the slice end shortened the last step we put back the dt we had learned so the next slice does not start from the short step.
+/// </summary>
+/// <param name="methodId"></param>
+/// <param name="sliceEnd"></param>
+/// <param name="maxSteps"></param>
+void OdeSolver::stepMethodTo(const unsigned int methodId, const double sliceEnd, const size_t maxSteps)
+{
+	//Count what we allocate under our method, as stage scratch unless a narrower scope says otherwise
+	MemoryScope memoryScope(MemoryTracker::CATEGORIES::STAGES, methodId);
+
+	//Get everything this method keeps between calls
+	unique_ptr<SolverIF>& currentMethod = methods.getMethodMap().find(methodId)->second;
+	OdeSolverParams& currentParameters = params.find(methodId)->second;
+	Richardson& currentTables = methods.getTableMap().find(methodId)->second;
+	MethodArena& arena = methods.getArenaMap().find(methodId)->second;
+	vector<StateVector>& results = resultMap.find(methodId)->second;
+
+	//Get our counters and count our right hand side evaluations into them
+	MethodStats& stats = statsMap.find(methodId)->second;
+	const CountingOdeFun countedProblem(stepperProblem, stats.rhsEvaluations);
+
+	//Get this current methods dt and time
+	double& dt = currentParameters.dt;
+	double& currentTime = currentParameters.currentTime;
+
+	//Save where this slice ends
+	currentParameters.sliceEnd = sliceEnd;
+
+	//Get our state and the scratch for the next state from our arena
+	const size_t stateSize = results.back().getState().size();
+	vec& currentState = arena.getBuffer(MethodArena::ARENA_BUFFERS::CURRENT_STATE, stateSize);
+	vec& newState = arena.getBuffer(MethodArena::ARENA_BUFFERS::NEW_STATE, stateSize);
+
+	//Step until we reach the end of the slice or take all our steps
+	for (size_t steps = 0; steps < maxSteps && currentTime < sliceEnd; ++steps)
+	{
+		//Save the dt we learned before the slice end can shorten it
+		const double learnedDt = dt;
+
+		try
+		{
+			//Solver for the next time step for the current method
+			currentState = buildSolution(currentMethod, methodId, currentTables, arena, currentParameters, currentState, newState, &countedProblem, currentTime, stepperEndTime);
+
+			//Throw away the step if it was stopped part way through
+			if (currentParameters.isPartial)
+			{
+				break;
+			}
+		}
+		catch (exception& e)
+		{
+			//Print our error and exit the program
+			cerr << e.what();
+			exit(1);
+		}
+
+		//Land exactly on the slice end if that is where the step was clamped to
+		const bool reachedEnd = currentTime + dt >= sliceEnd - std::numeric_limits<double>::epsilon() * std::fabs(sliceEnd);
+		currentTime = reachedEnd ? sliceEnd : currentTime + dt;
+
+		//Try to append the current results to our results map
+		try
+		{
+			//In real time mode we write over our latest result in place so the step does not allocate
+			if (currentParameters.realTime)
+			{
+				results.back().assign(currentState, currentParameters);
+			}
+			else
+			{
+				//Push back the result
+				MemoryScope resultScope(MemoryTracker::CATEGORIES::RESULTS);
+				results.emplace_back(currentState, currentParameters);
+			}
+		}
+		catch (exception& e)
+		{
+			cerr << e.what();
+			exit(1);
+		}
+
+		//Publish the accepted step
+		++stats.acceptedSteps;
+		publishProgress(methodId, currentParameters);
+		if (stepObserver != nullptr)
+		{
+			stepObserver->stepAccepted(methodId, progressSlots.find(methodId)->second->draft());
+		}
+
+		//Put back our learned dt if the slice end shortened the step
+		if (reachedEnd && dt < learnedDt)
+		{
+			dt = learnedDt;
+		}
+	}
+}
+
+/// <summary>
+/// Push the methods latest result to the consumer. This blocks while the queue is full so a slow consumer slows the method down.
+/// If the consumer went away we stop the run.
+/// </summary>
+/// <param name="methodId"></param>
+/// <param name="results"></param>
+void OdeSolver::streamResult(const unsigned int methodId, vector<StateVector>& results)
+{
+	//Check if we are streaming
+	if (stepQueue == nullptr)
+	{
+		return;
+	}
+
+	//Hand off the step
+	if (!stepQueue->push(methodId, results.back()))
+	{
+		runMonitor->requestStop();
+	}
+
+	//Only hold on to the latest result if the consumer is keeping the trajectory
+	if (!keepStreamedResults && results.size() > 1)
+	{
+		results.erase(results.begin(), results.end() - 1);
+	}
+}
+
+/// <summary>
+/// Run every method streaming each accepted step into the queue as soon as it is found.
+/// The queue is closed once every method is done so the consumer knows the stream ended.
+/// If the run throws the queue is left open so the caller can close it with the error before the consumer sees the end.
+/// </summary>
+/// <param name="problem"></param>
+/// <param name="initalConditions"></param>
+/// <param name="beginTime"></param>
+/// <param name="endTime"></param>
+/// <param name="queue"></param>
+/// <param name="keepResults"></param>
+/// <param name="token"></param>
+void OdeSolver::runStreaming(const OdeFunIF* problem, crvec initalConditions, const double beginTime, const double endTime, StepQueue& queue, const bool keepResults, const CancellationToken& token)
+{
+	//Stream into the queue for this run
+	stepQueue = &queue;
+	keepStreamedResults = keepResults;
+
+	try
+	{
+		run(problem, initalConditions, beginTime, endTime, token);
+	}
+	catch (...)
+	{
+		//Stop streaming and pass the error on, the caller closes the queue with it
+		stepQueue = nullptr;
+		keepStreamedResults = true;
+		throw;
+	}
+
+	//Stop streaming and let the consumer know we are done
+	stepQueue = nullptr;
+	keepStreamedResults = true;
+	queue.close();
+}
+
+/// <summary>
+/// Get the counters of a known enum Solver Type
+/// </summary>
+/// <param name="methodType"></param>
+/// <returns></returns>
+const MethodStats& OdeSolver::getStats(SolverIF::SOLVER_TYPES methodType) const
+{
+	return getStats(static_cast<unsigned int>(methodType));
+}
+
+/// <summary>
+/// Get the counters the method collected over the last run
+/// </summary>
+/// <param name="methodId"></param>
+/// <returns></returns>
+const MethodStats& OdeSolver::getStats(const unsigned int methodId) const
+{
+	//Check if the method being asked for is in our map
+	map<unsigned int, MethodStats>::const_iterator stats = statsMap.find(methodId);
+
+	//If the method is not found
+	if (stats == statsMap.cend())
+	{
+		throw invalid_argument("Invalid Method");
+	}
+
+	return stats->second;
+}
+
+/// <summary>
+/// Copy the parameters and step counts the progress record keeps into the methods draft and publish it
+/// </summary>
+/// <param name="methodId"></param>
+/// <param name="currentParams"></param>
+void OdeSolver::publishProgress(const unsigned int methodId, const OdeSolverParams& currentParams)
+{
+	ProgressSlot& slot = *progressSlots.find(methodId)->second;
+	ProgressRecord& record = slot.draft();
+
+	//Fill in the draft
+	record.currentTime = currentParams.currentTime;
+	record.dt = currentParams.dt;
+	record.currentTableSize = currentParams.currentTableSize;
+	record.currentError = currentParams.currentError;
+	record.totalError = currentParams.totalError;
+	record.totalTime = currentParams.totalTime;
+
+	//Copy our step counts
+	const MethodStats& stats = statsMap.find(methodId)->second;
+	record.acceptedSteps = stats.acceptedSteps;
+	record.retries = stats.retries;
+
+	//Let the readers see it
+	slot.publish();
+}
+
+/// <summary>
+/// Read the progress of a known enum Solver Type
+/// </summary>
+/// <param name="methodType"></param>
+/// <returns></returns>
+const ProgressRecord OdeSolver::getProgress(SolverIF::SOLVER_TYPES methodType) const
+{
+	return getProgress(static_cast<unsigned int>(methodType));
+}
+
+/// <summary>
+/// Read the last progress the method published. This never blocks the method.
+/// A method not in the run reads the empty record its slot was reset to.
+/// </summary>
+/// <param name="methodId"></param>
+/// <returns></returns>
+const ProgressRecord OdeSolver::getProgress(const unsigned int methodId) const
+{
+	//Check if the method being asked for is in our map
+	map<unsigned int, unique_ptr<ProgressSlot>>::const_iterator slot = progressSlots.find(methodId);
+
+	//If the method is not found
+	if (slot == progressSlots.cend())
+	{
+		throw invalid_argument("Invalid Method");
+	}
+
+	return slot->second->read();
+}
+
+/// <summary>
+/// Check if the current run was asked to stop. Runs without a monitor (ensembles) never stop early.
+/// </summary>
+/// <returns></returns>
+const bool OdeSolver::isStopRequested() const
+{
+	return runMonitor && runMonitor->isStopRequested();
+}
+
+const bool OdeSolver::isExplict(const unsigned int methodId) const
+{
+	switch (methodId)
+	{
+	case 10:
+	case 20:
+	case 30:
+	{
+		return true;
+	}
+	case 40:
+	case 50:
+	{
+		return false;
+	}
+	default:
+	{
+		throw std::invalid_argument("Method Id not found");
+	}
+	}
+}
+
+/// <summary>
+/// Run in auto select mode. Every method steps through a short calibration window from the same state and we measure what each one
+/// paid per unit of time advanced. Only the cheapest keeps going until the next reselection, when the others are moved to its state and
+/// calibrated again. A shift in the chosen methods dt brings the reselection forward since its cost was measured at the old dt.
+/// The calibration and solo steps of the chosen methods are stitched into the results of the method chosen last, the others end partial.
+/// </summary>
+/// <param name="problem"></param>
+/// <param name="initalConditions"></param>
+/// <param name="beginTime"></param>
+/// <param name="endTime"></param>
+/// <param name="token"></param>
+/// <param name="maxWallTime"></param>
+void OdeSolver::runAutoSelect(const OdeFunIF* problem, crvec initalConditions, const double beginTime, const double endTime, const CancellationToken& token, const double maxWallTime)
+{
+	//Start every method at the inital condition
+	startStepping(problem, initalConditions, beginTime, endTime);
+
+	//Start a fresh monitor for this run watching the callers token and deadline
+	runMonitor = std::make_unique<RunMonitor>(token, maxWallTime);
+
+	//Let the observer know we are starting
+	if (stepObserver != nullptr)
+	{
+		vector<unsigned int> methodIds;
+		for (paramMap::const_iterator paramItr = params.cbegin(); paramItr != params.cend(); ++paramItr)
+		{
+			methodIds.push_back(paramItr->first);
+		}
+		stepObserver->runStarted(beginTime, endTime, methodIds);
+	}
+
+	//The steps of the chosen methods starting from the inital condition
+	vector<StateVector> chosenResults(1, resultMap.begin()->second.front());
+	unsigned int chosenId = params.begin()->first;
+	double syncTime = beginTime;
+
+	const double interval = endTime - beginTime;
+	while (syncTime < endTime && !isStopRequested())
+	{
+		//Mark where each method starts the window
+		map<unsigned int, CalibrationMark> marks;
+		for (paramMap::const_iterator paramItr = params.cbegin(); paramItr != params.cend(); ++paramItr)
+		{
+			marks[paramItr->first] = { paramItr->second.currentTime, paramItr->second.totalTime, paramItr->second.totalError,
+				statsMap.find(paramItr->first)->second.rhsEvaluations, resultMap.find(paramItr->first)->second.size() };
+		}
+
+		//Calibrate everyone over the window
+		const double calibrationEnd = std::min(syncTime + generalParams.calibrationWindow * interval, endTime);
+		stepAllMethodsTo(calibrationEnd, std::numeric_limits<size_t>::max());
+
+		//Choose the cheapest
+		chosenId = selectCheapestMethod(marks, interval, chosenId);
+		selectionHistory.emplace_back(syncTime, chosenId);
+
+		//Keep its calibration steps
+		vector<StateVector>& chosenStates = resultMap.find(chosenId)->second;
+		MemoryScope resultScope(MemoryTracker::CATEGORIES::RESULTS, chosenId);
+		chosenResults.insert(chosenResults.end(), chosenStates.begin() + marks[chosenId].firstResult, chosenStates.end());
+
+		//Run it alone until the next reselection or until its dt drifts away from where it was measured
+		OdeSolverParams& chosenParams = params.find(chosenId)->second;
+		const double reselectEnd = std::min(calibrationEnd + generalParams.reselectInterval * interval, endTime);
+		const double calibratedDt = chosenParams.dt;
+		const size_t soloStart = chosenStates.size();
+		while (chosenParams.currentTime < reselectEnd && !isStopRequested() &&
+			chosenParams.dt <= calibratedDt * generalParams.reselectDtShift && chosenParams.dt >= calibratedDt / generalParams.reselectDtShift)
+		{
+			stepMethodTo(chosenId, reselectEnd, 1);
+		}
+		chosenResults.insert(chosenResults.end(), chosenStates.begin() + soloStart, chosenStates.end());
+		syncTime = chosenParams.currentTime;
+
+		//Bring everyone else along for the next window
+		if (syncTime < endTime && !isStopRequested())
+		{
+			syncMethodsTo(chosenId);
+		}
+	}
+
+	//The stitched steps become the results of the method chosen last and everyone else ends partial
+	for (paramMap::iterator paramItr = params.begin(); paramItr != params.end(); ++paramItr)
+	{
+		vector<StateVector>& currentResults = resultMap.find(paramItr->first)->second;
+		if (paramItr->first == chosenId)
+		{
+			currentResults = std::move(chosenResults);
+		}
+
+		if (paramItr->first != chosenId || paramItr->second.currentTime < endTime)
+		{
+			paramItr->second.isPartial = true;
+			currentResults.back().markPartial();
+		}
+
+		//Publish that we are done
+		progressSlots.find(paramItr->first)->second->draft().isFinished = true;
+		publishProgress(paramItr->first, paramItr->second);
+	}
+
+	//Tell the observer where everyone ended up
+	if (stepObserver != nullptr)
+	{
+		map<unsigned int, ProgressRecord> finalRecords;
+		for (paramMap::const_iterator paramItr = params.cbegin(); paramItr != params.cend(); ++paramItr)
+		{
+			finalRecords[paramItr->first] = progressSlots.find(paramItr->first)->second->read();
+		}
+		stepObserver->runCompleted(finalRecords);
+	}
+
+	//Keep what the methods learned for the next run
+	saveWarmStart();
+	collectMemory();
+
+	//The run is over
+	stepperProblem = nullptr;
+}
+
+/// <summary>
+/// Find the method that paid the least per unit of time advanced since its mark, by wall time or right hand side evaluations with the
+/// other breaking ties. A method is only considered if it covered the whole window and its error grew no faster than the error bound
+/// allows over the interval. If none qualify the error is ignored, and if none covered the window we keep the current method.
+/// </summary>
+/// <param name="marks"></param>
+/// <param name="interval"></param>
+/// <param name="currentId"></param>
+/// <returns></returns>
+const unsigned int OdeSolver::selectCheapestMethod(const map<unsigned int, CalibrationMark>& marks, const double interval, const unsigned int currentId) const
+{
+	//Get where the window ended
+	double windowEnd = -std::numeric_limits<double>::infinity();
+	for (paramMap::const_iterator paramItr = params.cbegin(); paramItr != params.cend(); ++paramItr)
+	{
+		windowEnd = std::max(windowEnd, paramItr->second.currentTime);
+	}
+
+	//Look for the cheapest with and without holding them to the error
+	for (const bool holdToError : { true, false })
+	{
+		unsigned int cheapestId = currentId;
+		double cheapestCost = std::numeric_limits<double>::infinity();
+		double cheapestTieBreak = std::numeric_limits<double>::infinity();
+
+		for (paramMap::const_iterator paramItr = params.cbegin(); paramItr != params.cend(); ++paramItr)
+		{
+			const OdeSolverParams& currentParams = paramItr->second;
+			const CalibrationMark& mark = marks.find(paramItr->first)->second;
+
+			//Skip methods that did not get through the window
+			const double advanced = currentParams.currentTime - mark.currentTime;
+			if (currentParams.isPartial || currentParams.currentTime < windowEnd || !(advanced > 0.0))
+			{
+				continue;
+			}
+
+			//Skip methods spending the error faster than the bound allows
+			if (holdToError && (currentParams.totalError - mark.totalError) / advanced * interval > currentParams.upperError)
+			{
+				continue;
+			}
+
+			//Get the cost per unit of time advanced
+			const double wallCost = (currentParams.totalTime - mark.totalTime) / advanced;
+			const double rhsCost = static_cast<double>(statsMap.find(paramItr->first)->second.rhsEvaluations - mark.rhsEvaluations) / advanced;
+			const bool byWallTime = currentParams.selectionCost == OdeSolverParams::SELECTION_COSTS::WALL_TIME;
+			const double cost = byWallTime ? wallCost : rhsCost;
+			const double tieBreak = byWallTime ? rhsCost : wallCost;
+
+			if (cost < cheapestCost || (cost == cheapestCost && tieBreak < cheapestTieBreak))
+			{
+				cheapestId = paramItr->first;
+				cheapestCost = cost;
+				cheapestTieBreak = tieBreak;
+			}
+		}
+
+		if (cheapestCost < std::numeric_limits<double>::infinity())
+		{
+			return cheapestId;
+		}
+	}
+
+	return currentId;
+}
+
+/// <summary>
+/// Move every other method to the state, time, and total error of the method so the next window starts them all from the same place.
+/// Each keeps the dt and table size it learned.
+/// </summary>
+/// <param name="methodId"></param>
+void OdeSolver::syncMethodsTo(const unsigned int methodId)
+{
+	//Get where the method is
+	const OdeSolverParams& sourceParams = params.find(methodId)->second;
+	const vec& sourceState = methods.getArenaMap().find(methodId)->second.getBuffer(MethodArena::ARENA_BUFFERS::CURRENT_STATE, resultMap.find(methodId)->second.back().getState().size());
+
+	for (paramMap::iterator paramItr = params.begin(); paramItr != params.end(); ++paramItr)
+	{
+		//Skip the method itself
+		if (paramItr->first == methodId)
+		{
+			continue;
+		}
+
+		//Take over its state
+		OdeSolverParams& currentParams = paramItr->second;
+		currentParams.currentTime = sourceParams.currentTime;
+		currentParams.totalError = sourceParams.totalError;
+		MemoryScope stateScope(MemoryTracker::CATEGORIES::STAGES, paramItr->first);
+		vec& currentState = methods.getArenaMap().find(paramItr->first)->second.getBuffer(MethodArena::ARENA_BUFFERS::CURRENT_STATE, sourceState.size());
+		currentState = sourceState;
+
+		//Add where we jumped to
+		MemoryScope resultScope(MemoryTracker::CATEGORIES::RESULTS, paramItr->first);
+		resultMap.find(paramItr->first)->second.emplace_back(currentState, currentParams);
+	}
+}
+
+/// <summary>
+/// Start each method with what it learned in the last run when warm starting and there is something saved for it, otherwise
+/// with the estimated inital dt if asked for, otherwise with the dt given in the parameters.
+/// A loaded profile may come from other parameters so its dt and table size are clamped into the ones we have.
+/// </summary>
+/// <param name="problem"></param>
+/// <param name="initalConditions"></param>
+/// <param name="beginTime"></param>
+/// <param name="endTime"></param>
+void OdeSolver::startMethods(const OdeFunIF* problem, crvec initalConditions, const double beginTime, const double endTime)
+{
+	for (paramMap::iterator paramItr = params.begin(); paramItr != params.end(); ++paramItr)
+	{
+		OdeSolverParams& currentParams = paramItr->second;
+
+		//Pick up where we left off
+		WarmStartEntry entry;
+		if (generalParams.warmStart && warmStartProfile.find(paramItr->first, beginTime, entry) && entry.dt > 0.0)
+		{
+			currentParams.dt = std::min(std::max(entry.dt, currentParams.smallestAllowableDt), endTime - beginTime);
+			currentParams.upgradeFactor = entry.upgradeFactor;
+			currentParams.currentTableSize = std::min(std::max(entry.tableSize, currentParams.minTableSize), currentParams.maxTableSize);
+
+			//Have the first pass of updateDt start the table search where we left off instead of at the smallest table
+			currentParams.isDtClamped = true;
+		}
+		//Otherwise estimate where to start
+		else if (generalParams.estimateInitalDt)
+		{
+			const double order = methods.getMethodMap().find(paramItr->first)->second->getErrorOrder();
+			currentParams.dt = estimateInitalDt(problem, initalConditions, beginTime, endTime, order, currentParams);
+		}
+	}
+}
+
+/// <summary>
+/// Save two entries for each method. The first is the dt and table size of its first accepted step (with no upgrade so a repeated run
+/// takes that same step). The second is where its last step not shortened to land on the end left it, so a run carrying on from there
+/// does not start from the sliver the end clamped the last step to.
+/// Methods that only hold their latest result (streaming without keeping them) save where they are now.
+/// </summary>
+void OdeSolver::saveWarmStart()
+{
+	for (paramMap::const_iterator paramItr = params.cbegin(); paramItr != params.cend(); ++paramItr)
+	{
+		const vector<StateVector>& currentResults = resultMap.find(paramItr->first)->second;
+		vector<WarmStartEntry> learned;
+
+		//Save the first step
+		if (currentResults.size() > 1)
+		{
+			const OdeSolverParams& firstParams = currentResults[1].getParams();
+			learned.push_back({ currentResults.front().getParams().currentTime, firstParams.dt, 0.0, firstParams.currentTableSize });
+		}
+
+		//Find the last step not clamped onto the end, falling back to where the method is now
+		const OdeSolverParams* lastParams = &paramItr->second;
+		for (size_t indx = currentResults.size(); indx > 1; --indx)
+		{
+			if (!currentResults[indx - 1].getParams().lastRun)
+			{
+				lastParams = &currentResults[indx - 1].getParams();
+				break;
+			}
+		}
+		learned.push_back({ paramItr->second.currentTime, lastParams->dt, lastParams->upgradeFactor, lastParams->currentTableSize });
+
+		warmStartProfile.set(paramItr->first, learned);
+	}
+}
+
+/// <summary>
+/// Estimate a first dt the way Hairer, Norsett, and Wanner do. With d0 and d1 the weighted RMS sizes of the state and its derivative
+/// a first guess h0 = .01 d0 / d1 takes one Euler step to measure the change in the derivative d2. The estimate is the step where
+/// max(d1, d2) h^(order + 1) = .01, kept within 100 h0, the smallest allowable dt, and the interval.
+/// The weights are the per component tolerances the error is measured with.
+/// </summary>
+/// <param name="problem"></param>
+/// <param name="initalConditions"></param>
+/// <param name="beginTime"></param>
+/// <param name="endTime"></param>
+/// <param name="order"></param>
+/// <param name="currentParams"></param>
+/// <returns></returns>
+const double OdeSolver::estimateInitalDt(const OdeFunIF* problem, crvec initalConditions, const double beginTime, const double endTime, const double order, const OdeSolverParams& currentParams)
+{
+	const size_t components = initalConditions.size();
+	const shared_ptr<const vec>& atol = currentParams.absoluteTolerance;
+	const shared_ptr<const vec>& rtol = currentParams.relativeTolerance;
+
+	//Weighted RMS norm with the tolerances of the component
+	const auto norm = [&](crvec values)
+	{
+		double sum = 0.0;
+		for (size_t i = 0; i < components; ++i)
+		{
+			const double absolute = (atol && atol->size() > 0) ? (*atol)[atol->size() == 1 ? 0 : i] : currentParams.upperError;
+			const double relative = (rtol && rtol->size() > 0) ? (*rtol)[rtol->size() == 1 ? 0 : i] : 0.0;
+			const double weighted = values[i] / (absolute + relative * std::fabs(initalConditions[i]));
+			sum += weighted * weighted;
+		}
+		return components > 0 ? std::sqrt(sum / static_cast<double>(components)) : 0.0;
+	};
+
+	//Size of the state and its derivative
+	vec initalDerivative(components);
+	(*problem)(initalDerivative, initalConditions, beginTime);
+	const double d0 = norm(initalConditions);
+	const double d1 = norm(initalDerivative);
+
+	//First guess and one Euler step with it
+	const double h0 = (d0 < 1e-5 || d1 < 1e-5) ? 1e-6 : .01 * d0 / d1;
+	const vec eulerState = initalConditions + static_cast<scalar>(h0) * initalDerivative;
+	vec eulerDerivative(components);
+	(*problem)(eulerDerivative, eulerState, beginTime + h0);
+	const vec derivativeChange = eulerDerivative - initalDerivative;
+	const double d2 = norm(derivativeChange) / h0;
+
+	//Step that keeps the leading error term at a hundredth of the tolerance
+	const double largest = std::max(d1, d2);
+	const double h1 = largest <= 1e-15 ? std::max(1e-6, h0 * 1e-3) : std::pow(.01 / largest, 1.0 / (order + 1.0));
+
+	return std::min(std::max(std::min(100.0 * h0, h1), currentParams.smallestAllowableDt), endTime - beginTime);
+}
+
+/// <summary>
+/// Start the peaks of each method over from what it holds now (the last runs results were already freed) and its allocations from zero
+/// </summary>
+void OdeSolver::markMemory()
+{
+	for (paramMap::const_iterator paramItr = params.cbegin(); paramItr != params.cend(); ++paramItr)
+	{
+		MemoryTracker::restart(paramItr->first);
+	}
+}
+
+/// <summary>
+/// Save the blocks each method allocated over the run
+/// </summary>
+void OdeSolver::collectMemory()
+{
+	for (map<unsigned int, MethodStats>::iterator statsItr = statsMap.begin(); statsItr != statsMap.end(); ++statsItr)
+	{
+		statsItr->second.allocations = MemoryTracker::getAllocations(statsItr->first);
+	}
+}
+
+/// <summary>
+/// Write a block per method with the current and peak bytes and allocations of each category, then the allocations per accepted step
+/// </summary>
+/// <param name="out"></param>
+void OdeSolver::writeMemoryReport(std::ostream& out) const
+{
+	//Let the caller know there is nothing to report
+	if (!MemoryTracker::isAvailable())
+	{
+		out << "Allocation counting is not built in (build with ODESOLVER_COUNT_ALLOCATIONS)\n";
+		return;
+	}
+
+	for (map<unsigned int, MethodStats>::const_iterator statsItr = statsMap.cbegin(); statsItr != statsMap.cend(); ++statsItr)
+	{
+		out << "Method " << statsItr->first << "\n";
+		out << std::setw(16) << "category" << std::setw(16) << "current bytes" << std::setw(16) << "peak bytes" << std::setw(14) << "allocations" << "\n";
+
+		for (size_t category = 0; category < static_cast<size_t>(MemoryTracker::CATEGORIES::CATEGORY_COUNT); ++category)
+		{
+			const MemoryTracker::Usage usage = MemoryTracker::getUsage(statsItr->first, static_cast<MemoryTracker::CATEGORIES>(category));
+			out << std::setw(16) << MemoryTracker::categoryName(static_cast<MemoryTracker::CATEGORIES>(category))
+				<< std::setw(16) << usage.currentBytes << std::setw(16) << usage.peakBytes << std::setw(14) << usage.allocations << "\n";
+		}
+
+		//Allocations over the run per step we kept
+		const MethodStats& stats = statsItr->second;
+		const double perStep = stats.acceptedSteps > 0 ? static_cast<double>(stats.allocations) / static_cast<double>(stats.acceptedSteps) : 0.0;
+		out << "Allocations this run: " << stats.allocations << "; per accepted step: " << std::setprecision(4) << perStep << "\n";
+	}
+}
@@ -5,19 +5,32 @@
 #include <cmath>
 #include <iomanip>
 #include <iostream>
+#include <iterator>
+#include <limits>
 #include <map>
 #include <memory>
-#include <mutex>
 #include <stdexcept>
 #include <thread>
 #include <vector>
 
+#include "CancellationToken.h"
+#include "CountingOdeFun.h"
+#include "EnsembleState.h"
+#include "MemoryTracker.h"
+#include "MethodStats.h"
 #include "MethodWrapperBase.h"
 #include "OdeSolverParams.h"
 #include "OdeFunIF.h"
+#include "ProgressSlot.h"
 #include "StateVector.h"
+#include "StepObserver.h"
+#include "StepQueue.h"
+#include "StepSchedule.h"
 #include "SolverIF.h"
 #include "Richardson.h"
+#include "RunMonitor.h"
+#include "Tracer.h"
+#include "WarmStartProfile.h"
 
 using std::map;
 using std::vector;
@@ -29,10 +42,10 @@ using std::cerr;
 using std::pow;
 using std::thread;
 using std::setprecision;
-using std::mutex;
 using paramMap = map<unsigned int, OdeSolverParams>;
 using resultNode = vector<StateVector>;
 using results = map<unsigned int, resultNode>;
+using ensembleNode = vector<resultNode>;
 using threadVector = vector<thread>;
 
 // Class to hold all the methods, results, and parameters.
@@ -56,24 +69,139 @@ private:
 	// The state vector will hold the state generated at the time and parameters used to solve for that time. 
 	map<unsigned int, vector<StateVector>> resultMap;
 
+	// This is the map of the solution of every ensemble member to the current method.
+	// Each member keeps its own vector of state vectors so it can be pulled out on its own.
+	map<unsigned int, ensembleNode> ensembleResultMap;
+
+	// Most results we reserve up front for each method. Past this the result vector grows on its own.
+	static const size_t maxReservedResults = 4096;
+
 	// This is a vector of threads that we will use to solve the problem in parallell for each method. 
 	// These will be updated in the core running section.
 	threadVector methodThreads;
 
+	// This is shared by the method threads of the current run so they can stop each other and signal when they finish.
+	unique_ptr<RunMonitor> runMonitor;
+
+	// Queue the accepted steps are streamed into while streaming (null otherwise).
+	// Without keeping the streamed results each method only holds on to its latest result.
+	StepQueue* stepQueue = nullptr;
+	bool keepStreamedResults = true;
+
+	// Stream the latest result of the method if we are streaming
+	void streamResult(const unsigned int, vector<StateVector>&);
+
+	// Observer told about the steps of each run (null keeps the run quiet). Not owned.
+	StepObserver* stepObserver = nullptr;
+
+	// Schedule the accepted steps of each run are recorded into and the schedule each run replays (null for neither). Not owned.
+	StepSchedule* stepRecording = nullptr;
+	const StepSchedule* stepReplay = nullptr;
+
+	// How far a method has gotten through the replayed schedule. A replayed step that misses the error hands the rest of its
+	// scheduled span to adaptive control so a poor schedule costs one rejected table per step rather than one per adaptive step.
+	struct ReplayPosition
+	{
+		size_t cursor = 0;
+		double stepEnd = 0.0;
+		double resumeTime = -std::numeric_limits<double>::infinity();
+	};
+
+	// This is the map of where each method is in the replayed schedule.
+	map<unsigned int, ReplayPosition> replayPositions;
+
+	// Take the dt and table size of the replayed step at the time if there is one
+	const bool replayStep(const unsigned int, OdeSolverParams&, const double, const double);
+
+	// What each method learned by the end of the last run, picked up by the next one with warm start.
+	WarmStartProfile warmStartProfile;
+
+	// Start each methods dt and table size from the warm start profile or the inital step estimate
+	void startMethods(const OdeFunIF*, crvec, const double, const double);
+
+	// Save what each method learned into the warm start profile
+	void saveWarmStart();
+
+	// Estimate a first dt for a method of the order from the size of the derivative and how fast it changes
+	static const double estimateInitalDt(const OdeFunIF*, crvec, const double, const double, const double, const OdeSolverParams&);
+
+	// Start the memory peaks and allocation counts of each method over at the start of a run
+	void markMemory();
+
+	// Save the blocks each method allocated over the run into its counters
+	void collectMemory();
+
+	// This is the map of the counters each method collects over a run.
+	map<unsigned int, MethodStats> statsMap;
+
+	// This is the map of the progress slot each method publishes its progress through so it can be read while the method runs.
+	// A slot is built for every method type when we are constructed and only reset between runs, so the map never changes under a reader.
+	map<unsigned int, unique_ptr<ProgressSlot>> progressSlots;
+
+	// Publish the progress of the method from its parameters
+	void publishProgress(const unsigned int, const OdeSolverParams&);
+
+	// Least fraction of the interval a racing method covers before its projected finish is trusted.
+	static constexpr double minRaceProgress = .05;
+
+	// Check if the current run was asked to stop
+	const bool isStopRequested() const;
+
+	// The problem and horizon of the current stepping session. Null until startStepping is called.
+	const OdeFunIF* stepperProblem = nullptr;
+	double stepperEndTime = 0.0;
+
+	// Take up to the number of accepted steps with one method toward the slice end, keeping its state in its arena.
+	void stepMethodTo(const unsigned int, const double, const size_t);
+
+	// Step every method toward the slice end on its own thread
+	void stepAllMethodsTo(const double, const size_t);
+
+	// Where a method was when a calibration window started
+	struct CalibrationMark
+	{
+		double currentTime;
+		double totalTime;
+		double totalError;
+		size_t rhsEvaluations;
+		size_t firstResult;
+	};
+
+	// The time each auto selection was made at and the method it picked
+	vector<std::pair<double, unsigned int>> selectionHistory;
+
+	// Run with only the method that was cheapest over the last calibration window, choosing again as the run goes
+	void runAutoSelect(const OdeFunIF*, crvec, const double, const double, const CancellationToken&, const double);
+
+	// Pick the method with the lowest cost per unit of time advanced since its mark that kept to the error, otherwise keep the current one
+	const unsigned int selectCheapestMethod(const map<unsigned int, CalibrationMark>&, const double, const unsigned int) const;
+
+	// Move every other method to the state and time the method reached
+	void syncMethodsTo(const unsigned int);
+
 	// This starts up saving all the parameters and seeing which methods the user wants.
 	// It will call on methodbasewrapper to build each method of what is allowed and build each method with a corresponding richardson table.
 	// It will also generate the result map and parameter map for each allowable method.
 	void setup();
 
+	// This starts every method over in place with our parameters, keeping the methods, tables, and arenas already built.
+	void resetRun();
+
+	// Check the inputs and start every method at the inital condition once the methods are built
+	void beginStepping(const OdeFunIF*, crvec, const double, const double);
+
 	// This will run the paticular method referenced in input arguments.
-	void runMethod(const OdeFunIF*, unique_ptr<SolverIF>&, const unsigned int, Richardson&, crvec, rvec, const OdeSolverParams&, const double, const double);
+	void runMethod(const OdeFunIF*, unique_ptr<SolverIF>&, const unsigned int, Richardson&, MethodArena&, crvec, rvec, const OdeSolverParams&, const double, const double);
 
-	// This will build the solution from the current time step to the next "best" time step.
-	vec buildSolution(unique_ptr<SolverIF>&, const unsigned int, Richardson&, OdeSolverParams&, crvec, const OdeFunIF*, const double, const double);
+	// This will run every row of the richardson table in lockstep so each stage is one batched function evaluation.
+	void runBatchedRows(const OdeFunIF*, unique_ptr<SolverIF>&, Richardson&, MethodArena&, crvec, rvec, const OdeSolverParams&, const double);
+
+	// This will build the solution from the current time step to the next "best" time step into the new state.
+	rvec buildSolution(unique_ptr<SolverIF>&, const unsigned int, Richardson&, MethodArena&, OdeSolverParams&, crvec, rvec, const OdeFunIF*, const double, const double);
 
 	// This updates the method to the next time step. 
 	// This is used in each thread. 
-	void updateNextTimeStep(const unsigned int, unique_ptr<SolverIF>&, OdeSolverParams&, Richardson&, const double, const double, const valarray<double>&, const OdeFunIF*, vector<StateVector>&);
+	void updateNextTimeStep(const unsigned int, unique_ptr<SolverIF>&, OdeSolverParams&, Richardson&, MethodArena&, const double, const double, const vec&, const OdeFunIF*, vector<StateVector>&);
 
 	// Check the error and determine if an upgrade or downgrade is required to satify the current estimated error. 
 	// If we fail and we are not on the last iteration, we will find the new dt and run the iteration scheme again
@@ -82,6 +210,25 @@ private:
 	//Check if our method is either implict or explict
 	const bool isExplict(const unsigned int) const;
 
+	// This will run the paticular method for every pending member of a packed ensemble.
+	void runEnsembleMethod(const OdeFunIF*, unique_ptr<SolverIF>&, Richardson&, MethodArena&, crvec, rvec, const timeVec&, const timeVec&, const maskVec&);
+
+	// This will move every active ensemble member to its next "best" time step. Members that converge are masked out of further retries.
+	void buildEnsembleSolution(unique_ptr<SolverIF>&, Richardson&, MethodArena&, vector<OdeSolverParams>&, rvec, const timeVec&, const maskVec&, const OdeFunIF*, const double);
+
+	// This updates every member of the ensemble to the end time in lockstep for one method.
+	// This is used in each thread.
+	void updateNextEnsembleStep(const unsigned int, unique_ptr<SolverIF>&, const OdeSolverParams&, Richardson&, MethodArena&, const double, const double, crvec, const size_t, const OdeFunIF*, ensembleNode&);
+
+	// Find the best results, preferring methods that reached the end time
+	map<unsigned int, vector<StateVector>>::const_iterator findBestResults() const;
+
+	// Find the best ensemble results for a member
+	const vector<StateVector>& findBestEnsembleResults(const size_t) const;
+
+	// Interpolate a vector of results to the desired time
+	static const StateVector interpolateResults(const vector<StateVector>&, const double);
+
 public:
 
 	//Delete the default constructor
@@ -105,12 +252,65 @@ public:
 	//Destructor using default
 	~OdeSolver() = default;
 
-	//Run our method
-	void run(const OdeFunIF*, crvec, const double, const double);
+	//Set the observer told about the steps of each run, null (the default) reports nothing. The observer must outlive the runs.
+	inline void setStepObserver(StepObserver* observer) { stepObserver = observer; };
+
+	//Record the accepted steps of each run into the schedule, null (the default) records nothing. The schedule must outlive the runs.
+	inline void setScheduleRecording(StepSchedule* schedule) { stepRecording = schedule; };
+
+	//Replay the schedule on each run, null (the default) replays nothing. The error of each replayed step is still checked and a step
+	//that misses it falls back to adaptive control. The schedule must outlive the runs and can not be the one being recorded into.
+	inline void setScheduleReplay(const StepSchedule* schedule) { stepReplay = schedule; };
+
+	//Get what each method learned by the end of the last run
+	inline const WarmStartProfile& getWarmStartProfile() const { return warmStartProfile; };
+
+	//Set what each method starts from on the next runs with warm start, for example a profile loaded from a file
+	inline void setWarmStartProfile(const WarmStartProfile& profile) { warmStartProfile = profile; };
+
+	//Run our method. The run stops early, keeping what it has marked partial, once the token is cancelled or the wall clock seconds run out.
+	void run(const OdeFunIF*, crvec, const double, const double, const CancellationToken& = CancellationToken(), const double = std::numeric_limits<double>::infinity());
+
+	//Get the time each auto selection was made at and the method it picked over the last run
+	inline const vector<std::pair<double, unsigned int>>& getSelectionHistory() const { return selectionHistory; };
+
+	//Run our method pushing every accepted step into the queue as it is found. The queue is closed once the run is done. If the run throws the queue is left open for the caller to close with the error.
+	void runStreaming(const OdeFunIF*, crvec, const double, const double, StepQueue&, const bool = true, const CancellationToken& = CancellationToken());
 
 	//Clear out our data for another run
 	void refreshParams(const OdeSolverParams&);
 
+	//Start stepping the problem from the inital condition up to at most the end time. The state, dt, table size, and scratch are kept between calls.
+	void startStepping(const OdeFunIF*, crvec, const double, const double);
+
+	//Start stepping again like startStepping but reuse the methods, tables, and scratch already built instead of rebuilding them (for running many instances)
+	void restartStepping(const OdeFunIF*, crvec, const double, const double);
+
+	//Advance every method to the time, appending to the results (replacing the latest one in real time mode)
+	void advanceTo(const double);
+
+	//Take one accepted step with every method, appending to the results (replacing the latest one in real time mode)
+	void step();
+
+	//Get the earliest time the methods have reached while stepping
+	const double getCurrentTime() const;
+
+	//Get a consistent snapshot of a methods progress. Safe to call from any thread while the run is going and across runs.
+	const ProgressRecord getProgress(SolverIF::SOLVER_TYPES) const;
+
+	//Get a consistent snapshot of a methods progress with an unsigned int if the enums are known
+	const ProgressRecord getProgress(const unsigned int) const;
+
+	//Get the counters a method collected over the last run (read them once the run is done, use getProgress while it runs)
+	const MethodStats& getStats(SolverIF::SOLVER_TYPES) const;
+
+	//Get the counters a method collected over the last run with an unsigned int if the enums are known
+	const MethodStats& getStats(const unsigned int) const;
+
+	//Write the bytes each method holds now and at its peak over the last run by category, and its allocations per accepted step.
+	//Needs the counting layer built in (ODESOLVER_COUNT_ALLOCATIONS) and turned on with MemoryTracker::enable before the run.
+	void writeMemoryReport(std::ostream&) const;
+
 	//Get the results for a given type
 	const vector<StateVector>& getResults(SolverIF::SOLVER_TYPES) const;
 
@@ -128,5 +328,23 @@ public:
 
 	//Find the best result and return the state vector interplation of that result
 	const StateVector getStateAndTime(const double) const;
+
+	//Run every inital condition of an ensemble in lockstep
+	void runEnsemble(const OdeFunIF*, const vector<vec>&, const double, const double);
+
+	//Get the number of members solved in the last ensemble run
+	const size_t getEnsembleSize() const;
+
+	//Get the results of an ensemble member for a given type
+	const vector<StateVector>& getEnsembleResults(SolverIF::SOLVER_TYPES, const size_t) const;
+
+	//Get the results of the best method for an ensemble member
+	const vector<StateVector>& getEnsembleResults(const size_t) const;
+
+	//Get the state of an ensemble member for a given type and time
+	const StateVector getEnsembleStateAndTime(SolverIF::SOLVER_TYPES, const size_t, const double) const;
+
+	//Get the state of an ensemble member with the best method at a time
+	const StateVector getEnsembleStateAndTime(const size_t, const double) const;
 };
 
@@ -1,12 +1,16 @@
 #pragma once
 
 #include <array>
+#include <memory>
 #include <stdexcept>
 
 #include "SolverIF.h"
+#include "ThreadAffinity.h"
 
 using std::array;
 using std::invalid_argument;
+using std::make_shared;
+using std::shared_ptr;
 
 class OdeSolverParams
 {
@@ -16,6 +20,24 @@ public:
 	//Check user inputs
 	inline bool checkUserInputs() const;
 
+	//Check the tolerances line up with a state of this many components
+	inline bool checkTolerances(const size_t) const;
+
+	//Enumerations for how the richardson error is measured
+	enum class ERROR_NORMS
+	{
+		MAX_ABS			= 0, //Unweighted max abs difference
+		WEIGHTED_RMS	= 1, //Root mean square of the difference over atol + rtol * |y|
+		WEIGHTED_MAX	= 2  //Max of the difference over atol + rtol * |y|
+	};
+
+	//Enumerations for what auto select compares the methods by
+	enum class SELECTION_COSTS
+	{
+		WALL_TIME	= 0, //Wall time spent building steps per unit of time advanced
+		RHS_CALLS	= 1  //Right hand side evaluations per unit of time advanced
+	};
+
 	//Allowed Methods
 	bool useEuler;
 	bool useRK2;
@@ -30,6 +52,17 @@ public:
 	double totalError;
 	bool satifiesError;
 
+	//Error norm and its per component tolerances.
+	//An empty tolerance uses upperError for atol and zero for rtol, a single entry covers every component.
+	//The weighted norms are scaled by upperError so a norm of one sits on the upper error bound.
+	//The tolerances are shared so copying the parameters with every result does not copy them.
+	ERROR_NORMS errorNorm;
+	shared_ptr<const vec> absoluteTolerance;
+	shared_ptr<const vec> relativeTolerance;
+
+	//Set the per component tolerances and the weighted norm to use them with
+	inline void setTolerances(const vec&, const vec&, const ERROR_NORMS = ERROR_NORMS::WEIGHTED_RMS);
+
 	//Allowed deleta time
 	double minDt;
 	double maxDt;
@@ -42,6 +75,52 @@ public:
 	//flag for last run
 	bool lastRun;
 
+	//flag for results that stopped before the end time
+	bool isPartial;
+
+	//flag for stepping in slices: reaching the end of a slice shortens the step but keeps the error control and does not end the run.
+	//The error is still projected out to the end time so the slices share one error budget.
+	bool isStepping;
+	double sliceEnd;
+
+	//Race mode: the first method to reach the end time within the error stops the others.
+	//With stopProjectedLosers a method also stops once another is projected to finish raceLossFactor times faster.
+	bool isRace;
+	bool stopProjectedLosers;
+	double raceLossFactor;
+
+	//Auto select mode: every method steps through a calibration window (a fraction of the interval) from the same state and only the
+	//one with the lowest selection cost per unit of time advanced keeps going. The choice is made again every reselectInterval of the
+	//interval, or sooner once the chosen methods dt drifts by more than reselectDtShift either way from where it was chosen.
+	bool autoSelect;
+	SELECTION_COSTS selectionCost;
+	double calibrationWindow;
+	double reselectInterval;
+	double reselectDtShift;
+
+	//Where each method starts its dt and table size. With warmStart a method picks up what it learned by the end of the last run
+	//(or from a loaded profile), otherwise with estimateInitalDt its first dt is estimated from the problem and the tolerances.
+	bool warmStart;
+	bool estimateInitalDt;
+
+	//Real time mode: each step has a fixed budget. The tables never grow past maxTableSize (what every buffer is preallocated for),
+	//a step builds at most realTimeMaxRetries tables after its first, and a retry is only started if it is projected to finish within
+	//realTimeBudget seconds (and realTimeRhsBudget right hand side evaluations unless that is zero) of the step starting.
+	//A step out of retries or budget keeps the table with the smallest error it built and flags its result with budgetExceeded.
+	//Real time mode runs a single method, so stepping stays on the callers thread, and while stepping it keeps only its latest result
+	//so a step does not allocate. run() still caps the retries and budget of each step but keeps every result, so it allocates as it goes.
+	bool realTime;
+	size_t realTimeMaxRetries;
+	double realTimeBudget;
+	size_t realTimeRhsBudget;
+
+	//flag for results a real time step accepted without meeting the error because it ran out of retries or budget
+	bool budgetExceeded;
+
+	//How the method threads started by run and the worker pools are pinned to cores.
+	//A pinned method thread also allocates its own tables, scratch, and results so they land on its NUMA node.
+	ThreadAffinity::PLACEMENT threadPlacement;
+
 	//Error of the constant
 	double c;
 
@@ -125,13 +204,35 @@ OdeSolverParams::OdeSolverParams(const array<bool, 5>& allowedMethods = { true,f
 	c(-1.0),
 	lastRun(false),
 	totalError(0.0),
+	errorNorm(ERROR_NORMS::MAX_ABS),
+	absoluteTolerance(nullptr),
+	relativeTolerance(nullptr),
 	currentTime(0.0),
 	smallestAllowableDt(smallestAllowableDtIn),
 	upgradeFactor(-1.),
 	implictDt(implictParams[0]),
 	implictError(implictParams[1]),
 	maxIter(maxIterIn),
-	totalTime(0.0)
+	totalTime(0.0),
+	isPartial(false),
+	isStepping(false),
+	sliceEnd(0.0),
+	isRace(false),
+	stopProjectedLosers(false),
+	raceLossFactor(2.0),
+	autoSelect(false),
+	selectionCost(SELECTION_COSTS::WALL_TIME),
+	calibrationWindow(.02),
+	reselectInterval(.25),
+	reselectDtShift(4.0),
+	warmStart(false),
+	estimateInitalDt(false),
+	realTime(false),
+	realTimeMaxRetries(2),
+	realTimeBudget(1e-3),
+	realTimeRhsBudget(0),
+	budgetExceeded(false),
+	threadPlacement(ThreadAffinity::PLACEMENT::NONE)
 {
 	//If the inputs are invalid we do no want to continue
 	if (!checkUserInputs())
@@ -157,13 +258,76 @@ bool OdeSolverParams::checkUserInputs() const
 	//Make sure we have a valid reduction factor
 	goodArgs &= (redutionFactor > 1);
 
+	//Make sure the race parameters are valid
+	goodArgs &= isfinite(raceLossFactor) && raceLossFactor >= 1.0;
+
+	//Make sure the auto select parameters are valid
+	goodArgs &= calibrationWindow > 0.0 && calibrationWindow <= 1.0 && reselectInterval > 0.0 && isfinite(reselectInterval) && reselectDtShift > 1.0;
+
+	//Make sure the real time parameters are valid. Real time mode runs one method (more would each step on their own thread) and
+	//auto select compares whole result histories so it can not run in real time.
+	const int enabledMethods = useEuler + useRK2 + useRK4 + useImplictEuler + useCrank;
+	goodArgs &= isfinite(realTimeBudget) && realTimeBudget > 0.0 && !(realTime && (autoSelect || enabledMethods > 1));
+
 	//Make sure the implict parameters are valid
 	goodArgs &= isfinite(implictDt) && isfinite(implictError) && implictDt > 0.0 && implictError > 0.0 && maxIter > 0;
 
+	//Make sure the tolerances are valid (the absolute tolerance must be positive so the weights never divide by zero)
+	if (absoluteTolerance)
+	{
+		for (const scalar& atol : *absoluteTolerance)
+		{
+			goodArgs &= isfinite(atol) && atol > 0.0;
+		}
+	}
+	if (relativeTolerance)
+	{
+		for (const scalar& rtol : *relativeTolerance)
+		{
+			goodArgs &= isfinite(rtol) && rtol >= 0.0;
+		}
+	}
+
 	//Return if the arguments are valid
 	return goodArgs;
 }
 
+/// <summary>
+/// Each tolerance must be empty, a single entry, or one entry per component
+/// </summary>
+/// <param name="components"></param>
+/// <returns></returns>
+bool OdeSolverParams::checkTolerances(const size_t components) const
+{
+	//Check a single tolerance vector
+	const auto fits = [components](const shared_ptr<const vec>& tolerance)
+	{
+		return !tolerance || tolerance->size() == 0 || tolerance->size() == 1 || tolerance->size() == components;
+	};
+
+	return fits(absoluteTolerance) && fits(relativeTolerance);
+}
+
+/// <summary>
+/// Set the per component absolute and relative tolerances and the norm to measure the error with
+/// </summary>
+/// <param name="atol"></param>
+/// <param name="rtol"></param>
+/// <param name="norm"></param>
+void OdeSolverParams::setTolerances(const vec& atol, const vec& rtol, const ERROR_NORMS norm)
+{
+	//Save off the tolerances
+	absoluteTolerance = make_shared<const vec>(atol);
+	relativeTolerance = make_shared<const vec>(rtol);
+	errorNorm = norm;
+
+	//If the tolerances are invalid we do no want to continue
+	if (!checkUserInputs())
+	{
+		throw invalid_argument("Invalid ODE tolerances");
+	}
+}
+
 const OdeSolverParams& OdeSolverParams::operator=(const OdeSolverParams& params)
 {
 	//Copy all the parameters over
@@ -190,7 +354,29 @@ const OdeSolverParams& OdeSolverParams::operator=(const OdeSolverParams& params)
 	satifiesError = params.satifiesError;
 	c = params.c;
 	lastRun = params.lastRun;
+	isPartial = params.isPartial;
+	isStepping = params.isStepping;
+	sliceEnd = params.sliceEnd;
+	isRace = params.isRace;
+	stopProjectedLosers = params.stopProjectedLosers;
+	raceLossFactor = params.raceLossFactor;
+	autoSelect = params.autoSelect;
+	selectionCost = params.selectionCost;
+	calibrationWindow = params.calibrationWindow;
+	reselectInterval = params.reselectInterval;
+	reselectDtShift = params.reselectDtShift;
+	warmStart = params.warmStart;
+	estimateInitalDt = params.estimateInitalDt;
+	realTime = params.realTime;
+	realTimeMaxRetries = params.realTimeMaxRetries;
+	realTimeBudget = params.realTimeBudget;
+	realTimeRhsBudget = params.realTimeRhsBudget;
+	budgetExceeded = params.budgetExceeded;
+	threadPlacement = params.threadPlacement;
 	totalError = params.totalError;
+	errorNorm = params.errorNorm;
+	absoluteTolerance = params.absoluteTolerance;
+	relativeTolerance = params.relativeTolerance;
 	currentTime = params.currentTime;
 	smallestAllowableDt = params.smallestAllowableDt;
 	upgradeFactor = params.upgradeFactor;
@@ -0,0 +1,63 @@
+#include "ParameterSweep.h"
+
+/// <summary>
+/// Start the pool and give each worker its own solver
+/// </summary>
+/// <param name="paramsIn"></param>
+/// <param name="workers"></param>
+ParameterSweep::ParameterSweep(const OdeSolverParams& paramsIn, const size_t workers) :
+	sweepParams(paramsIn),
+	pool(workers, paramsIn.threadPlacement),
+	elapsedTime(0.0)
+{
+	for (size_t worker = 0; worker < pool.getWorkerCount(); ++worker)
+	{
+		solvers.push_back(std::make_unique<OdeSolver>(sweepParams));
+	}
+}
+
+/// <summary>
+/// Solve every parameter set on the pool. Each instance is stepped straight to the end time on its workers solver, which keeps the
+/// methods, tables, and scratch it built for its first instance, and the final state of the best method is copied into its slot of the output.
+/// </summary>
+/// <param name="factory"></param>
+/// <param name="parameterSets"></param>
+/// <param name="initalConditions"></param>
+/// <param name="beginTime"></param>
+/// <param name="endTime"></param>
+void ParameterSweep::run(const problemFactory& factory, const vector<vec>& parameterSets, const vector<vec>& initalConditions, const double beginTime, const double endTime)
+{
+	//Check the inital conditions line up with the sets
+	if (initalConditions.empty() || (initalConditions.size() != 1 && initalConditions.size() != parameterSets.size()))
+	{
+		throw invalid_argument("Need one inital condition or one for each parameter set");
+	}
+
+	//Size the output up front so the workers only write into their own slot
+	finalStates.assign(parameterSets.size(), StateVector(vec(0.0, initalConditions.front().size()), sweepParams));
+
+	//Get the current time
+	std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+
+	//Solve every set
+	pool.parallelFor(parameterSets.size(), [&](const size_t indx, const size_t worker)
+		{
+			//Build this instance
+			const unique_ptr<OdeFunIF> problem = factory(parameterSets[indx]);
+			crvec initalCondition = initalConditions.size() == 1 ? initalConditions.front() : initalConditions[indx];
+
+			//Solve it on our workers solver, only starting its state, time, and parameters over
+			OdeSolver& solver = *solvers[worker];
+			solver.restartStepping(problem.get(), initalCondition, beginTime, endTime);
+			solver.advanceTo(endTime);
+
+			//Save the final state of the best method
+			finalStates[indx] = solver.getResults().back();
+		});
+
+	//Get the second time point
+	std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
+
+	//Save the duriation of time
+	elapsedTime = std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1).count();
+}
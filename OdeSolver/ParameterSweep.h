@@ -0,0 +1,69 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "OdeFunIF.h"
+#include "OdeSolver.h"
+#include "OdeSolverParams.h"
+#include "StateVector.h"
+#include "WorkStealingPool.h"
+
+using std::function;
+using std::invalid_argument;
+using std::unique_ptr;
+using std::vector;
+using problemFactory = function<unique_ptr<OdeFunIF>(crvec)>;
+
+// Class to run one solver configuration over many parameter sets.
+// The instances are spread over a work stealing pool so sets that are much more expensive than the rest (ones that clamp dt) do not
+// leave the other workers idle. Each worker keeps its own solver between instances and the final states go into an output sized up front.
+class ParameterSweep
+{
+private:
+
+	//Configuration every instance is solved with
+	OdeSolverParams sweepParams;
+
+	//Workers running the instances
+	WorkStealingPool pool;
+
+	//One solver per worker reused for every instance it runs
+	vector<unique_ptr<OdeSolver>> solvers;
+
+	//Final state of the best method for each parameter set
+	vector<StateVector> finalStates;
+
+	//Wall time of the last sweep
+	double elapsedTime;
+
+public:
+
+	//Build the workers and their solvers (zero workers uses the hardware concurrency)
+	ParameterSweep(const OdeSolverParams&, const size_t = 0);
+
+	//Can not copy the workers
+	ParameterSweep(const ParameterSweep&) = delete;
+	ParameterSweep& operator=(const ParameterSweep&) = delete;
+
+	//Default Delete operator
+	~ParameterSweep() = default;
+
+	//Solve the problem built for every parameter set. The inital conditions are either one shared by all or one per set.
+	void run(const problemFactory&, const vector<vec>&, const vector<vec>&, const double, const double);
+
+	//Get the final state of each parameter set from the last sweep
+	inline const vector<StateVector>& getResults() const { return finalStates; };
+
+	//Get the wall time of the last sweep
+	inline double getElapsedTime() const { return elapsedTime; };
+
+	//Get the throughput of the last sweep
+	inline double getSolvesPerSecond() const { return elapsedTime > 0.0 ? static_cast<double>(finalStates.size()) / elapsedTime : 0.0; };
+
+	//Get the number of workers
+	inline size_t getWorkerCount() const { return pool.getWorkerCount(); };
+};
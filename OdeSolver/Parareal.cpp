@@ -0,0 +1,233 @@
+#include "Parareal.h"
+
+/// <summary>
+/// Build the workers and their fine and coarse solvers. The fine solver only runs RK4.
+/// The slices are all the same length so each fine slice solver gets one slices share of the error bounds and tolerances.
+/// </summary>
+/// <param name="paramsIn"></param>
+/// <param name="slicesIn"></param>
+/// <param name="coarseStepsIn"></param>
+/// <param name="workers"></param>
+Parareal::Parareal(const OdeSolverParams& paramsIn, const size_t slicesIn, const int coarseStepsIn, const size_t workers) :
+	fineParams(paramsIn),
+	sliceParams(paramsIn),
+	slices(slicesIn),
+	coarseSteps(coarseStepsIn),
+	pool(workers, paramsIn.threadPlacement),
+	iterations(0),
+	pararealTime(0.0),
+	serialTime(0.0),
+	serialDifference(0.0)
+{
+	//Check we have something to split up
+	if (slices == 0 || coarseSteps <= 0)
+	{
+		throw invalid_argument("Parareal needs at least one slice and one coarse step");
+	}
+
+	//The fine propagator is RK4 with richardson extrapolation
+	fineParams.useEuler = false;
+	fineParams.useRK2 = false;
+	fineParams.useRK4 = true;
+	fineParams.useImplictEuler = false;
+	fineParams.useCrank = false;
+
+	//Split the error bounds over the slices so their errors add up to at most the bounds over the whole interval
+	const double share = 1.0 / static_cast<double>(slices);
+	sliceParams = fineParams;
+	sliceParams.upperError *= share;
+	sliceParams.lowerError *= share;
+
+	//The weighted norms measure against the tolerances themselves so split those too
+	if (fineParams.absoluteTolerance && fineParams.relativeTolerance)
+	{
+		sliceParams.setTolerances(*fineParams.absoluteTolerance * static_cast<scalar>(share), *fineParams.relativeTolerance * static_cast<scalar>(share), fineParams.errorNorm);
+	}
+
+	//Give each worker its own solvers
+	for (size_t worker = 0; worker < pool.getWorkerCount(); ++worker)
+	{
+		fineSolvers.push_back(std::make_unique<OdeSolver>(sliceParams));
+	}
+	coarseSolvers.resize(pool.getWorkerCount());
+}
+
+/// <summary>
+/// Take the coarse Euler steps over the slice
+/// </summary>
+/// <param name="worker"></param>
+/// <param name="problem"></param>
+/// <param name="startState"></param>
+/// <param name="endState"></param>
+/// <param name="beginTime"></param>
+/// <param name="endTime"></param>
+void Parareal::coarsePropagate(const size_t worker, const OdeFunIF* problem, crvec startState, rvec endState, const double beginTime, const double endTime)
+{
+	Euler& coarse = coarseSolvers[worker];
+	coarse.update(startState, endState, (endTime - beginTime) / static_cast<double>(coarseSteps), beginTime, coarseSteps, problem);
+}
+
+/// <summary>
+/// Step the fine solver across the slice and keep its results
+/// </summary>
+/// <param name="worker"></param>
+/// <param name="problem"></param>
+/// <param name="startState"></param>
+/// <param name="endState"></param>
+/// <param name="beginTime"></param>
+/// <param name="endTime"></param>
+/// <param name="results"></param>
+void Parareal::finePropagate(const size_t worker, const OdeFunIF* problem, crvec startState, rvec endState, const double beginTime, const double endTime, vector<StateVector>& results)
+{
+	OdeSolver& fine = *fineSolvers[worker];
+	fine.startStepping(problem, startState, beginTime, endTime);
+	fine.advanceTo(endTime);
+
+	results = fine.getResults();
+	endState = results.back().getState();
+}
+
+/// <summary>
+/// Run Parareal. Slices before the iteration count are exact so each iteration only reruns the fine solver on the slices after them.
+/// </summary>
+/// <param name="problem"></param>
+/// <param name="initalConditions"></param>
+/// <param name="beginTime"></param>
+/// <param name="endTime"></param>
+/// <param name="compareSerial"></param>
+void Parareal::run(const OdeFunIF* problem, crvec initalConditions, const double beginTime, const double endTime, const bool compareSerial)
+{
+	//Check we have somewhere to go
+	if (!(endTime > beginTime))
+	{
+		throw invalid_argument("End time must be after the begin time");
+	}
+
+	//Get the current time
+	std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+
+	//Cut the interval into slices
+	boundaryTimes.resize(slices + 1);
+	for (size_t n = 0; n <= slices; ++n)
+	{
+		boundaryTimes[n] = beginTime + (endTime - beginTime) * static_cast<double>(n) / static_cast<double>(slices);
+	}
+	boundaryTimes.back() = endTime;
+
+	//Size our coarse propagators
+	for (Euler& coarse : coarseSolvers)
+	{
+		coarse.initalize(initalConditions);
+	}
+
+	//Scratch for each slices fine and coarse end states
+	vector<vec> fineStates(slices, initalConditions);
+	vector<vec> coarseStates(slices, initalConditions);
+	vec newCoarse(initalConditions);
+	sliceResults.assign(slices, vector<StateVector>());
+
+	//Inital coarse sweep for our first guess
+	boundaryStates.assign(slices + 1, initalConditions);
+	for (size_t n = 0; n < slices; ++n)
+	{
+		coarsePropagate(pool.getWorkerCount() - 1, problem, boundaryStates[n], coarseStates[n], boundaryTimes[n], boundaryTimes[n + 1]);
+		boundaryStates[n + 1] = coarseStates[n];
+	}
+
+	//Iterate until the boundaries stop moving (after every slice has been corrected the answer is the serial fine one)
+	iterations = 0;
+	size_t exactSlices = slices;
+	for (size_t k = 0; k < slices; ++k)
+	{
+		//Run the fine solver on every slice that is not converged yet in parallel
+		pool.parallelFor(slices - k, [&](const size_t indx, const size_t worker)
+			{
+				const size_t n = k + indx;
+				finePropagate(worker, problem, boundaryStates[n], fineStates[n], boundaryTimes[n], boundaryTimes[n + 1], sliceResults[n]);
+			});
+		++iterations;
+
+		//Slice k is now exact
+		double largestChange = 0.0;
+		for (size_t i = 0; i < initalConditions.size(); ++i)
+		{
+			largestChange = std::max(largestChange, static_cast<double>(std::abs(fineStates[k][i] - boundaryStates[k + 1][i])));
+		}
+		boundaryStates[k + 1] = fineStates[k];
+
+		//Correct the rest in serial: new coarse + fine - old coarse
+		for (size_t n = k + 1; n < slices; ++n)
+		{
+			coarsePropagate(pool.getWorkerCount() - 1, problem, boundaryStates[n], newCoarse, boundaryTimes[n], boundaryTimes[n + 1]);
+
+			for (size_t i = 0; i < initalConditions.size(); ++i)
+			{
+				const scalar corrected = newCoarse[i] + fineStates[n][i] - coarseStates[n][i];
+				largestChange = std::max(largestChange, static_cast<double>(std::abs(corrected - boundaryStates[n + 1][i])));
+				boundaryStates[n + 1][i] = corrected;
+			}
+
+			coarseStates[n] = newCoarse;
+		}
+
+		//Stop once the boundaries converged
+		if (largestChange <= fineParams.upperError)
+		{
+			exactSlices = k + 1;
+			break;
+		}
+	}
+
+	//The slices after the exact ones were last run from boundaries the correction has moved since, so run them again from the final
+	//boundaries to keep their results on the trajectory we return
+	if (exactSlices < slices)
+	{
+		pool.parallelFor(slices - exactSlices, [&](const size_t indx, const size_t worker)
+			{
+				const size_t n = exactSlices + indx;
+				finePropagate(worker, problem, boundaryStates[n], fineStates[n], boundaryTimes[n], boundaryTimes[n + 1], sliceResults[n]);
+			});
+	}
+
+	//Get the second time point
+	std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
+	pararealTime = std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1).count();
+
+	//Time the serial fine run to compare against
+	serialTime = 0.0;
+	serialDifference = 0.0;
+	if (compareSerial)
+	{
+		std::chrono::high_resolution_clock::time_point t3 = std::chrono::high_resolution_clock::now();
+
+		//The serial run gets the whole error bounds over the whole interval
+		OdeSolver serialSolver(fineParams);
+		serialSolver.startStepping(problem, initalConditions, beginTime, endTime);
+		serialSolver.advanceTo(endTime);
+		crvec serialState = serialSolver.getResults().back().getState();
+
+		std::chrono::high_resolution_clock::time_point t4 = std::chrono::high_resolution_clock::now();
+		serialTime = std::chrono::duration_cast<std::chrono::duration<double>>(t4 - t3).count();
+
+		for (size_t i = 0; i < serialState.size(); ++i)
+		{
+			serialDifference = std::max(serialDifference, static_cast<double>(std::abs(serialState[i] - boundaryStates.back()[i])));
+		}
+	}
+}
+
+/// <summary>
+/// Stitch the slices together dropping the repeated start of each slice after the first.
+/// Every slice was run from its final boundary so a slice ends within upperError of where the next one starts.
+/// </summary>
+/// <returns></returns>
+vector<StateVector> Parareal::getResults() const
+{
+	vector<StateVector> stitched;
+	for (size_t n = 0; n < sliceResults.size(); ++n)
+	{
+		stitched.insert(stitched.end(), sliceResults[n].begin() + (n == 0 || sliceResults[n].empty() ? 0 : 1), sliceResults[n].end());
+	}
+
+	return stitched;
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "Euler.h"
+#include "OdeFunIF.h"
+#include "OdeSolver.h"
+#include "OdeSolverParams.h"
+#include "StateVector.h"
+#include "WorkStealingPool.h"
+
+using std::invalid_argument;
+using std::unique_ptr;
+using std::vector;
+
+// Class to integrate one long trajectory in parallel in time with Parareal.
+// The interval is cut into slices. A cheap coarse propagator (Euler with a few large steps per slice) sweeps across the slices in serial
+// while the accurate fine propagator (RK4 with richardson extrapolation) runs every slice in parallel from the current guess at its start.
+// Each iteration corrects the slice boundaries with the difference between the two and we stop once the boundaries move less than upperError.
+// Each slice is solved to its share of the error bounds so the slices together stay within the bounds asked for over the whole interval.
+class Parareal
+{
+private:
+
+	//Configuration of the fine solver over the whole interval
+	OdeSolverParams fineParams;
+
+	//Configuration of the fine solver over one slice (the error bounds scaled down to the slices share of the interval)
+	OdeSolverParams sliceParams;
+
+	//Number of slices the interval is cut into
+	const size_t slices;
+
+	//Number of Euler steps the coarse propagator takes over one slice
+	const int coarseSteps;
+
+	//Workers running the fine slices
+	WorkStealingPool pool;
+
+	//One fine solver per worker
+	vector<unique_ptr<OdeSolver>> fineSolvers;
+
+	//One coarse propagator per worker
+	vector<Euler> coarseSolvers;
+
+	//Slice boundary times and states
+	vector<double> boundaryTimes;
+	vector<vec> boundaryStates;
+
+	//Fine results of each slice from the last iteration
+	vector<vector<StateVector>> sliceResults;
+
+	//Iterations the last run took
+	size_t iterations;
+
+	//Wall time of the parareal run and of the serial fine run it is compared to
+	double pararealTime;
+	double serialTime;
+
+	//Largest difference between the parareal and serial end states
+	double serialDifference;
+
+	//Run the coarse propagator over a slice
+	void coarsePropagate(const size_t, const OdeFunIF*, crvec, rvec, const double, const double);
+
+	//Run the fine propagator over a slice saving its results
+	void finePropagate(const size_t, const OdeFunIF*, crvec, rvec, const double, const double, vector<StateVector>&);
+
+public:
+
+	//Build with the fine configuration, the number of slices, coarse steps per slice, and workers (zero uses the hardware concurrency)
+	Parareal(const OdeSolverParams&, const size_t, const int = 1, const size_t = 0);
+
+	//Can not copy the workers
+	Parareal(const Parareal&) = delete;
+	Parareal& operator=(const Parareal&) = delete;
+
+	//Default Delete operator
+	~Parareal() = default;
+
+	//Integrate the problem. Timing a serial fine run to report the speedup solves the whole interval again so it is off by default.
+	void run(const OdeFunIF*, crvec, const double, const double, const bool = false);
+
+	//Get the fine results of every slice stitched together (each run from its final boundary, so the slices meet within upperError)
+	vector<StateVector> getResults() const;
+
+	//Get the state at the end time
+	inline crvec getFinalState() const { return boundaryStates.back(); };
+
+	//Get the number of iterations the last run took
+	inline size_t getIterations() const { return iterations; };
+
+	//Get the wall time of the parareal run
+	inline double getPararealTime() const { return pararealTime; };
+
+	//Get the wall time of the serial run
+	inline double getSerialTime() const { return serialTime; };
+
+	//Get the speedup over the serial run (zero if it was not timed)
+	inline double getSpeedup() const { return pararealTime > 0.0 ? serialTime / pararealTime : 0.0; };
+
+	//Get the largest difference between the parareal and serial end states
+	inline double getSerialDifference() const { return serialDifference; };
+};
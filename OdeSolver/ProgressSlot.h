@@ -0,0 +1,157 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+using std::atomic;
+
+// Compact snapshot of how far a method has gotten
+struct ProgressRecord
+{
+	//Time the method reached
+	double currentTime = 0.0;
+
+	//Step size and table size it is using
+	double dt = 0.0;
+	size_t currentTableSize = 0;
+
+	//Error of the last step and the total so far
+	double currentError = 0.0;
+	double totalError = 0.0;
+
+	//Wall time spent building steps
+	double totalTime = 0.0;
+
+	//Steps accepted and table rebuilds thrown away since the run started
+	size_t acceptedSteps = 0;
+	size_t retries = 0;
+
+	//Flag once the method is done with the run
+	bool isFinished = false;
+};
+
+// Slot one method thread publishes its progress through while anyone else reads it.
+// This is a sequence lock: the writer makes the sequence odd while it stores the fields and even once it is done,
+// and a reader retries until it sees the same even sequence on both sides of its loads. The writer never waits and readers never block it.
+// Only the owning method thread may touch the draft or publish.
+class ProgressSlot
+{
+private:
+
+	//Odd while a publish is in progress
+	atomic<size_t> sequence;
+
+	//The published fields
+	atomic<double> currentTime;
+	atomic<double> dt;
+	atomic<size_t> currentTableSize;
+	atomic<double> currentError;
+	atomic<double> totalError;
+	atomic<double> totalTime;
+	atomic<size_t> acceptedSteps;
+	atomic<size_t> retries;
+	atomic<bool> isFinished;
+
+	//Record the writer fills in before publishing it (never read by other threads)
+	ProgressRecord pending;
+
+public:
+
+	//Start with an empty record
+	inline ProgressSlot();
+
+	//Can not copy or move the atomics
+	ProgressSlot(const ProgressSlot&) = delete;
+	ProgressSlot& operator=(const ProgressSlot&) = delete;
+
+	//Default Delete operator
+	inline ~ProgressSlot() = default;
+
+	//Get the writers draft of the next record
+	inline ProgressRecord& draft() { return pending; };
+
+	//Publish the draft
+	inline void publish();
+
+	//Publish an empty record for the next run (only while no method thread is using the slot)
+	inline void reset() { pending = ProgressRecord(); publish(); };
+
+	//Read a consistent copy of the last published record
+	inline ProgressRecord read() const;
+};
+
+ProgressSlot::ProgressSlot() :
+	sequence(0),
+	currentTime(0.0),
+	dt(0.0),
+	currentTableSize(0),
+	currentError(0.0),
+	totalError(0.0),
+	totalTime(0.0),
+	acceptedSteps(0),
+	retries(0),
+	isFinished(false)
+{
+	//Nothing else to do here
+}
+
+/// <summary>
+/// Mark the slot busy, store every field, and mark it done
+/// </summary>
+void ProgressSlot::publish()
+{
+	//Go odd so readers know to retry
+	const size_t start = sequence.load(std::memory_order_relaxed);
+	sequence.store(start + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	//Store the fields
+	currentTime.store(pending.currentTime, std::memory_order_relaxed);
+	dt.store(pending.dt, std::memory_order_relaxed);
+	currentTableSize.store(pending.currentTableSize, std::memory_order_relaxed);
+	currentError.store(pending.currentError, std::memory_order_relaxed);
+	totalError.store(pending.totalError, std::memory_order_relaxed);
+	totalTime.store(pending.totalTime, std::memory_order_relaxed);
+	acceptedSteps.store(pending.acceptedSteps, std::memory_order_relaxed);
+	retries.store(pending.retries, std::memory_order_relaxed);
+	isFinished.store(pending.isFinished, std::memory_order_relaxed);
+
+	//Go even again releasing the fields with it
+	sequence.store(start + 2, std::memory_order_release);
+}
+
+/// <summary>
+/// Load the fields until no publish happened while we were reading them
+/// </summary>
+/// <returns></returns>
+ProgressRecord ProgressSlot::read() const
+{
+	ProgressRecord record;
+	while (true)
+	{
+		//Wait out a publish in progress
+		const size_t before = sequence.load(std::memory_order_acquire);
+		if (before % 2 == 1)
+		{
+			continue;
+		}
+
+		//Load the fields
+		record.currentTime = currentTime.load(std::memory_order_relaxed);
+		record.dt = dt.load(std::memory_order_relaxed);
+		record.currentTableSize = currentTableSize.load(std::memory_order_relaxed);
+		record.currentError = currentError.load(std::memory_order_relaxed);
+		record.totalError = totalError.load(std::memory_order_relaxed);
+		record.totalTime = totalTime.load(std::memory_order_relaxed);
+		record.acceptedSteps = acceptedSteps.load(std::memory_order_relaxed);
+		record.retries = retries.load(std::memory_order_relaxed);
+		record.isFinished = isFinished.load(std::memory_order_relaxed);
+
+		//Keep them if nothing was published in the middle
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (sequence.load(std::memory_order_relaxed) == before)
+		{
+			return record;
+		}
+	}
+}
@@ -4,7 +4,7 @@
 /// Initalize our current state vector - call previous method Euler as functionality does not change
 /// </summary>
 /// <param name="initalConditionsIn"></param>
-void RK2::initalize(const valarray<double>& initalConditionsIn)
+void RK2::initalize(const vec& initalConditionsIn)
 {
 	Euler::initalize(initalConditionsIn);
 }
@@ -17,11 +17,12 @@ void RK2::initalizeSolverVectors()
 	//Update the current solver vector size
 	currentMethod.k1.resize(currentMethod.getCurrentState().size());
 	currentMethod.k2.resize(currentMethod.getCurrentState().size());
+	currentMethod.stageState.resize(currentMethod.getCurrentState().size());
 }
 
-valarray<double>& RK2::update(
-	const valarray<double>& previousState,
-	valarray<double>& newState,
+vec& RK2::update(
+	const vec& previousState,
+	vec& newState,
 	const double& dt,
 	const double& tBegin,
 	const int& numOfSteps,
@@ -38,10 +39,11 @@ valarray<double>& RK2::update(
 	{
 		//Get the function vector at the current time
 		k1 = functionVector->operator()(k1, currentState, currentTime);
-		k2 = functionVector->operator()(k2, currentState + 0.5 * dt * k1, currentTime + 0.5 * dt);
+		addScaled(stageState, currentState, 0.5 * dt, k1);
+		k2 = functionVector->operator()(k2, stageState, currentTime + 0.5 * dt);
 
 		//Update to the next time step and save the current state
-		currentState += dt * k2;
+		addScaled(currentState, currentState, dt, k2);
 
 		//Update the time step to the next time
 		updateTimeStep(dt, currentTime);
@@ -54,6 +56,65 @@ valarray<double>& RK2::update(
 	return newState;
 }
 
+/// <summary>
+/// Find the state of every active ensemble member at the next time step using the midpoint rule
+/// </summary>
+/// <param name="previousStates"></param>
+/// <param name="newStates"></param>
+/// <param name="dts"></param>
+/// <param name="times"></param>
+/// <param name="numOfSteps"></param>
+/// <param name="active"></param>
+/// <param name="functionVector"></param>
+/// <returns></returns>
+rvec RK2::update(crvec previousStates, rvec newStates, const timeVec& dts, const timeVec& times, const int& numOfSteps, const maskVec& active, const OdeFunIF* functionVector)
+{
+	//Update the currentState
+	currentState = previousStates;
+
+	//Save each members current time
+	ensembleTimes = times;
+
+	//Line each members dt up with the packed state
+	if (ensembleDt.size() != previousStates.size())
+	{
+		ensembleDt.resize(previousStates.size());
+	}
+	EnsembleState::tile(dts, ensembleDt);
+
+	//Size the stage scratch for the packed state
+	if (stageState.size() != previousStates.size())
+	{
+		stageState.resize(previousStates.size());
+	}
+	if (stageTimes.size() != times.size())
+	{
+		stageTimes.resize(times.size());
+	}
+
+	//Iterate through time
+	for (int i = 0; i < numOfSteps; ++i)
+	{
+		//Get the function vector for each member
+		evaluateEnsemble(functionVector, k1, currentState, ensembleTimes, active);
+		addScaled(stageState, currentState, 0.5, ensembleDt, k1);
+		addScaled(stageTimes, ensembleTimes, 0.5, dts);
+		evaluateEnsemble(functionVector, k2, stageState, stageTimes, active);
+
+		//Update every member to its next time step
+		addScaled(currentState, currentState, 1.0, ensembleDt, k2);
+
+		//Update each members time
+		ensembleTimes += dts;
+	}
+
+	//Save off the final current state to the new state
+	newStates = currentState;
+
+	//Return the new states
+	return newStates;
+}
+
 /// <summary>
 /// Will run the implict solver. Will fail as RK2 is not implict
 /// </summary>
@@ -12,7 +12,7 @@ class RK2 : public Euler
 protected:
 
 	//Vector to hold function vector
-	valarray<double> k2;
+	vec k2;
 
 private:
 
@@ -34,14 +34,17 @@ public:
 	virtual ~RK2() = default;
 
 	//Initalize the vector
-	virtual void initalize(const valarray<double>&) override;
+	virtual void initalize(const vec&) override;
 
 	//Get the next time step for rvec for explict methods
-	virtual rvec update(const valarray<double>&, valarray<double>&, const double&, const double&, const int&, const OdeFunIF*) override;
+	virtual rvec update(const vec&, vec&, const double&, const double&, const int&, const OdeFunIF*) override;
 
 	//Get the next time step for rvec for implict methods
 	virtual rvec update(crvec, rvec, const double&, const double&, const int&, const OdeFunIF*, const double&, const double&) override;
 
+	//Get the next time step for every active member of a packed ensemble
+	virtual rvec update(crvec, rvec, const timeVec&, const timeVec&, const int&, const maskVec&, const OdeFunIF*) override;
+
 	//Get the power of the error
 	virtual const double getErrorOrder() const override;
 };
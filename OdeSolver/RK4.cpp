@@ -16,6 +16,7 @@ void RK4::initalizeSolverVectors()
 	currentMethod.k2.resize(currentMethod.currentState.size());
 	currentMethod.k3.resize(currentMethod.currentState.size());
 	currentMethod.k4.resize(currentMethod.currentState.size());
+	currentMethod.stageState.resize(currentMethod.currentState.size());
 }
 
 rvec RK4::update(crvec previousState, rvec newState, const double& dt, const double& beginTime, const int& numOfSteps, const OdeFunIF* problem)
@@ -31,12 +32,18 @@ rvec RK4::update(crvec previousState, rvec newState, const double& dt, const dou
 	{
 		//Update all our solvers
 		k1 = problem->operator()(k1, currentState, currentTime);
-		k2 = problem->operator()(k2, currentState + dt * (k1 / 2.0), currentTime + dt / 2.0);
-		k3 = problem->operator()(k3, currentState + dt * (k2 / 2.0), currentTime + dt / 2.0);
-		k4 = problem->operator()(k4, currentState + dt * k3, currentTime + dt);
+		addScaled(stageState, currentState, dt / 2.0, k1);
+		k2 = problem->operator()(k2, stageState, currentTime + dt / 2.0);
+		addScaled(stageState, currentState, dt / 2.0, k2);
+		k3 = problem->operator()(k3, stageState, currentTime + dt / 2.0);
+		addScaled(stageState, currentState, dt, k3);
+		k4 = problem->operator()(k4, stageState, currentTime + dt);
 
 		//Update the current state with the weighted average
-		currentState += (dt / 6.) * (k1 + 2.0 * k2 + 2.0 * k3 + k4);
+		for (size_t j = 0; j < currentState.size(); ++j)
+		{
+			currentState[j] += static_cast<scalar>((dt / 6.) * (k1[j] + 2.0 * k2[j] + 2.0 * k3[j] + k4[j]));
+		}
 
 		//Update the time step
 		updateTimeStep(dt, currentTime);
@@ -49,6 +56,73 @@ rvec RK4::update(crvec previousState, rvec newState, const double& dt, const dou
 	return newState;
 }
 
+/// <summary>
+/// Find the state of every active ensemble member at the next time step using the classic RK4 weights
+/// </summary>
+/// <param name="previousStates"></param>
+/// <param name="newStates"></param>
+/// <param name="dts"></param>
+/// <param name="times"></param>
+/// <param name="numOfSteps"></param>
+/// <param name="active"></param>
+/// <param name="problem"></param>
+/// <returns></returns>
+rvec RK4::update(crvec previousStates, rvec newStates, const timeVec& dts, const timeVec& times, const int& numOfSteps, const maskVec& active, const OdeFunIF* problem)
+{
+	//Update the current state
+	currentState = previousStates;
+
+	//Save each members current time
+	ensembleTimes = times;
+
+	//Line each members dt up with the packed state
+	if (ensembleDt.size() != previousStates.size())
+	{
+		ensembleDt.resize(previousStates.size());
+	}
+	EnsembleState::tile(dts, ensembleDt);
+
+	//Size the stage scratch for the packed state
+	if (stageState.size() != previousStates.size())
+	{
+		stageState.resize(previousStates.size());
+	}
+	if (stageTimes.size() != times.size())
+	{
+		stageTimes.resize(times.size());
+	}
+
+	//Iterate through time
+	for (int i = 0; i < numOfSteps; ++i)
+	{
+		//Update all our solvers
+		evaluateEnsemble(problem, k1, currentState, ensembleTimes, active);
+		addScaled(stageState, currentState, 0.5, ensembleDt, k1);
+		addScaled(stageTimes, ensembleTimes, 0.5, dts);
+		evaluateEnsemble(problem, k2, stageState, stageTimes, active);
+		addScaled(stageState, currentState, 0.5, ensembleDt, k2);
+		evaluateEnsemble(problem, k3, stageState, stageTimes, active);
+		addScaled(stageState, currentState, 1.0, ensembleDt, k3);
+		addScaled(stageTimes, ensembleTimes, 1.0, dts);
+		evaluateEnsemble(problem, k4, stageState, stageTimes, active);
+
+		//Update the current state with the weighted average
+		for (size_t j = 0; j < currentState.size(); ++j)
+		{
+			currentState[j] += static_cast<scalar>((ensembleDt[j] / 6.) * (k1[j] + 2.0 * k2[j] + 2.0 * k3[j] + k4[j]));
+		}
+
+		//Update each members time
+		ensembleTimes += dts;
+	}
+
+	//Save the currentState
+	newStates = currentState;
+
+	//Return the new states
+	return newStates;
+}
+
 /// <summary>
 /// Will run the implict solver. Will fail as RK4 is not implict.
 /// </summary>
@@ -43,6 +43,9 @@ public:
 	//Get the next time step for rvec for implict methods
 	virtual rvec update(crvec, rvec, const double&, const double&, const int&, const OdeFunIF*, const double&, const double&) override;
 
+	//Get the next time step for every active member of a packed ensemble
+	virtual rvec update(crvec, rvec, const timeVec&, const timeVec&, const int&, const maskVec&, const OdeFunIF*) override;
+
 	//Get the power of the error
 	virtual const double getErrorOrder() const override;
 };
@@ -2,31 +2,40 @@
 
 void Richardson::BuildTables(const size_t tableSize, const size_t vecSize)
 {
-	try 
-	{
-		//Resize the table
-		result.resize(tableSize);
+	//Only reallocate if the table grew or the vector size changed
+	const bool needsBuild = !isBuilt || tableSize > result.size() || result[0][0].size() != vecSize;
 
-		//Resize each column
-		for (size_t i = 0; i < result.size(); ++i)
+	if (needsBuild)
+	{
+		try 
 		{
-			result[i].resize(tableSize);
-		}
+			//Resize the table
+			result.resize(tableSize);
 
-		//Initalize all the stored vectors
-		for (size_t i = 0; i < result.size(); ++i)
-		{
-			for (size_t j = 0; j < result.size(); ++j)
+			//Resize each column
+			for (size_t i = 0; i < result.size(); ++i)
 			{
-				result[i][j].resize(vecSize);
+				result[i].resize(tableSize);
+			}
+
+			//Initalize all the stored vectors
+			for (size_t i = 0; i < result.size(); ++i)
+			{
+				for (size_t j = 0; j < result.size(); ++j)
+				{
+					result[i][j].resize(vecSize);
+				}
 			}
 		}
+		catch (exception& e)
+		{
+			cerr << e.what();
+			exit(-1);
+		}
 	}
-	catch (exception& e)
-	{
-		cerr << e.what();
-		exit(-1);
-	}
+
+	//Save the size we are using
+	N = static_cast<unsigned int>(tableSize);
 
 	isBuilt = true;
 }
@@ -40,24 +49,24 @@ void Richardson::initalizeSteps(const double& reduct, const double& dt)
 	stepSize = dt;
 }
 
-void Richardson::append(const size_t rowIndx, const size_t colIndx, valarray<double>&& currentResult)
+void Richardson::append(const size_t rowIndx, const size_t colIndx, vec&& currentResult)
 {
-	try
-	{
-		result[rowIndx][colIndx] = currentResult;
-	}
-	catch (exception& e)
-	{
-		cerr << e.what();
-		exit(-1);
-	}
+	//The table stores its own precision so there is nothing to steal
+	append(rowIndx, colIndx, static_cast<const vec&>(currentResult));
 }
 
-void Richardson::append(const size_t rowIndx, const size_t colIndx, const valarray<double>& currentResult)
+void Richardson::append(const size_t rowIndx, const size_t colIndx, const vec& currentResult)
 {
 	try
 	{
-		result[rowIndx][colIndx] = currentResult;
+		//Get the entry we are writing to
+		accVec& entry = result[rowIndx][colIndx];
+
+		//Copy the result into the table converting to the accumulate precision
+		for (size_t k = 0; k < entry.size(); ++k)
+		{
+			entry[k] = static_cast<accScalar>(currentResult[k]);
+		}
 	}
 	catch (exception& e)
 	{
@@ -66,43 +75,107 @@ void Richardson::append(const size_t rowIndx, const size_t colIndx, const valarr
 	}
 }
 
+/// <summary>
+/// Save off how the error is measured. The weighted norms divide each difference by atol + rtol * |y| and scale by upperError
+/// so the norm is in the same units updateDt compares against.
+/// </summary>
+/// <param name="params"></param>
+/// <param name="members"></param>
+void Richardson::setErrorNorm(const OdeSolverParams& params, const size_t members)
+{
+	errorNorm = params.errorNorm;
+	absoluteTolerance = params.absoluteTolerance;
+	relativeTolerance = params.relativeTolerance;
+	errorScale = params.upperError;
+	packedMembers = members;
+}
+
+accScalar Richardson::weightedDifference(const size_t indx) const
+{
+	//Get the last two diagonal entries
+	const accScalar best = result[N - 1][N - 1][indx];
+	const accScalar previous = result[N - 2][N - 2][indx];
+
+	//Get the component this index belongs to
+	const size_t component = indx / packedMembers;
+
+	//Get the tolerances for the component
+	const accScalar atol = (absoluteTolerance && absoluteTolerance->size() > 0) ?
+		(*absoluteTolerance)[absoluteTolerance->size() == 1 ? 0 : component] : static_cast<accScalar>(errorScale);
+	const accScalar rtol = (relativeTolerance && relativeTolerance->size() > 0) ?
+		(*relativeTolerance)[relativeTolerance->size() == 1 ? 0 : component] : static_cast<accScalar>(0.0);
+
+	return std::abs(best - previous) / (atol + rtol * std::abs(best));
+}
+
 double Richardson::normedError() const
 {
-	//Get the error vector
-	vec error = result[result.size() - 1][result.size() - 1] - result[result.size() - 2][result.size() - 2];
-	//vec error = result[result.size() - 1][result.size() - 1] - result[0][0];
+	//Get the last two diagonal entries
+	const accVec& best = result[N - 1][N - 1];
+	const accVec& previous = result[N - 2][N - 2];
 
-	for_each(std::begin(error), std::end(error), [](double& elIn)
+	//Take the norm without building an error vector
+	accScalar error = 0.0;
+	switch (errorNorm)
+	{
+	case OdeSolverParams::ERROR_NORMS::WEIGHTED_RMS:
+		for (size_t i = 0; i < best.size(); ++i)
 		{
-			elIn = std::abs(elIn);
-		});
-
-	return error.max();
+			const accScalar difference = weightedDifference(i);
+			error += difference * difference;
+		}
+		return errorScale * sqrt(static_cast<double>(error) / static_cast<double>(best.size()));
+	case OdeSolverParams::ERROR_NORMS::WEIGHTED_MAX:
+		for (size_t i = 0; i < best.size(); ++i)
+		{
+			error = std::max(error, weightedDifference(i));
+		}
+		return errorScale * error;
+	default:
+		for (size_t i = 0; i < best.size(); ++i)
+		{
+			error = std::max(error, std::abs(best[i] - previous[i]));
+		}
+		return error;
+	}
 }
 
 const double Richardson::error(rvec bestResult, double& c)
 {
-	//Get ref to the current object
-	Richardson& currentTable = *this;
+	TraceSpan errorSpan(Tracer::SPAN_TYPES::RICHARDSON_ERROR);
 
 	//Iterate through the rows of the table
-	for (size_t i = 1; i < result.size(); ++i)
+	for (size_t i = 1; i < N; ++i)
 	{
 		//Iterate through the columns
 		for (size_t j = 0; j < i; ++j)
 		{
-			//Get the updated result
-			vec updatedResult = (pow(reductionFactor, static_cast<double>(j) + 1.)
-				* result[i][j] - result[i - 1][j])
-				/ (pow(reductionFactor, static_cast<double>(j) + 1.) - 1.);
+			//Get the extrapolation factor
+			const accScalar factor = static_cast<accScalar>(pow(reductionFactor, static_cast<double>(j) + 1.));
 
-			//Save the updated result to the table
-			currentTable.append(i, j + 1, std::move(updatedResult));
+			//Get the entries we extrapolate from and the entry we write to
+			const accVec& fineResult = result[i][j];
+			const accVec& coarseResult = result[i - 1][j];
+			accVec& updatedResult = result[i][j + 1];
+
+			//Save the updated result to the table in place
+			for (size_t k = 0; k < updatedResult.size(); ++k)
+			{
+				updatedResult[k] = (factor * fineResult[k] - coarseResult[k]) / (factor - static_cast<accScalar>(1.));
+			}
 		}
 	}
 
-	//Get the last result as that is the "best one"
-	bestResult = result[result.size() - 1][result.size() - 1];
+	//Get the last result as that is the "best one" back in the state precision
+	const accVec& best = result[N - 1][N - 1];
+	if (bestResult.size() != best.size())
+	{
+		bestResult.resize(best.size());
+	}
+	for (size_t k = 0; k < best.size(); ++k)
+	{
+		bestResult[k] = static_cast<scalar>(best[k]);
+	}
 	currentNormError = normedError();
 
 	//Set c to our approximaation of convergence
@@ -112,9 +185,59 @@ const double Richardson::error(rvec bestResult, double& c)
 	return currentNormError;
 }
 
+/// <summary>
+/// Split the normed error up by ensemble member. The table holds packed states so component i of a member sits at i * members + member.
+/// </summary>
+/// <param name="errors"></param>
+/// <param name="members"></param>
+void Richardson::memberErrors(accVec& errors, const size_t members) const
+{
+	//Get the last two diagonal entries
+	const accVec& best = result[N - 1][N - 1];
+	const accVec& previous = result[N - 2][N - 2];
+
+	//Size the errors to the members
+	if (errors.size() != members)
+	{
+		errors.resize(members);
+	}
+	errors = 0.0;
+
+	//Take the norm over each members components
+	switch (errorNorm)
+	{
+	case OdeSolverParams::ERROR_NORMS::WEIGHTED_RMS:
+		for (size_t i = 0; i < best.size(); ++i)
+		{
+			const accScalar difference = weightedDifference(i);
+			errors[i % members] += difference * difference;
+		}
+		for (size_t member = 0; member < members; ++member)
+		{
+			errors[member] = static_cast<accScalar>(errorScale * sqrt(static_cast<double>(errors[member]) * static_cast<double>(members) / static_cast<double>(best.size())));
+		}
+		break;
+	case OdeSolverParams::ERROR_NORMS::WEIGHTED_MAX:
+		for (size_t i = 0; i < best.size(); ++i)
+		{
+			accScalar& memberError = errors[i % members];
+			memberError = std::max(memberError, weightedDifference(i));
+		}
+		errors *= static_cast<accScalar>(errorScale);
+		break;
+	default:
+		for (size_t i = 0; i < best.size(); ++i)
+		{
+			accScalar& memberError = errors[i % members];
+			memberError = std::max(memberError, std::abs(best[i] - previous[i]));
+		}
+		break;
+	}
+}
+
 const size_t Richardson::getTableSize() const
 {
-	return result.size();
+	return N;
 }
 
 const double Richardson::getReductionFactor() const
@@ -7,10 +7,12 @@
 #include <stdexcept>
 #include <valarray>
 
+#include "OdeSolverParams.h"
 #include "SolverIF.h"
+#include "Tracer.h"
 
-//Some renaming for convience
-using vecValArray = valarray<vec>;
+//Some renaming for convience (the tables are stored in the accumulate precision)
+using vecValArray = valarray<accVec>;
 using mat = valarray<vecValArray>;
 using rmat = mat&;
 using crmat = const rmat;
@@ -30,6 +32,9 @@ private:
 	//Calculate the vector norm
 	double normedError() const;
 
+	//Get the difference of the last two diagonal entries at an index weighted by its tolerance
+	inline accScalar weightedDifference(const size_t) const;
+
 	//Our Result Matrix
 	mat result;
 
@@ -42,9 +47,18 @@ private:
 	//Our current step size
 	double stepSize = 0;
 
-	//Our table size
+	//Our table size in use (the stored table can be larger so changing sizes does not reallocate)
 	unsigned int N = 0;
 
+	//How the error is measured and the tolerances it is weighted by
+	OdeSolverParams::ERROR_NORMS errorNorm = OdeSolverParams::ERROR_NORMS::MAX_ABS;
+	shared_ptr<const vec> absoluteTolerance;
+	shared_ptr<const vec> relativeTolerance;
+	double errorScale = 1.0;
+
+	//Number of packed members the tolerances repeat over
+	size_t packedMembers = 1;
+
 	//Flag to check if tables are built
 	bool isBuilt = false;
 
@@ -65,15 +79,21 @@ public:
 	//Initalize our steps
 	void initalizeSteps(const double&, const double&);
 
+	//Set the error norm and tolerances from the parameters (members > 1 for packed ensembles)
+	void setErrorNorm(const OdeSolverParams&, const size_t = 1);
+
 	//Append result moving the result
-	void append(const size_t, const size_t, valarray<double>&&);
+	void append(const size_t, const size_t, vec&&);
 
 	//Append the result copying the result
-	void append(const size_t, const size_t, const valarray<double>&);
+	void append(const size_t, const size_t, const vec&);
 
 	//Get the error, updated vector, and estimate of the orders constant
 	const double error(rvec, double&);
 
+	//Get the error of each member of a packed ensemble (call after error)
+	void memberErrors(accVec&, const size_t) const;
+
 	//Get the table size
 	const size_t getTableSize() const;
 
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <mutex>
+
+#include "CancellationToken.h"
+
+using std::atomic;
+using std::map;
+using std::mutex;
+using std::unique_lock;
+
+// Class shared by the method threads of one run.
+// It lets the methods stop each other cooperatively and keeps the projected finish of each racing method.
+// The run also stops once the callers token is cancelled or the wall clock deadline passes.
+class RunMonitor
+{
+private:
+
+	//Guards the projections
+	mutex monitorLock;
+
+	//Set once the methods should stop at their next step
+	atomic<bool> stopRequested;
+
+	//Projected wall time each racing method needs to reach the end time
+	map<unsigned int, double> projectedFinish;
+
+	//Callers token to cancel the run
+	const CancellationToken token;
+
+	//Wall clock time the run must stop by
+	const std::chrono::steady_clock::time_point deadline;
+
+	//Flag if we have a deadline at all
+	const bool hasDeadline;
+
+public:
+
+	//Start with no projections, the token to watch, and the wall clock seconds the run is allowed
+	inline RunMonitor(const CancellationToken& = CancellationToken(), const double = std::numeric_limits<double>::infinity());
+
+	//Can not copy or move the synchronization
+	RunMonitor(const RunMonitor&) = delete;
+	RunMonitor& operator=(const RunMonitor&) = delete;
+
+	//Default Delete operator
+	inline ~RunMonitor() = default;
+
+	//Ask every method to stop at its next step
+	inline void requestStop() { stopRequested.store(true, std::memory_order_release); };
+
+	//Check if the methods were asked to stop, were cancelled, or ran out of time
+	inline bool isStopRequested() const;
+
+	//Mark one method as finished taking it out of the race
+	inline void methodFinished(const unsigned int);
+
+	//Save a methods projected finish and check if another method is projected to finish faster by the factor
+	inline bool isProjectedToLose(const unsigned int, const double, const double);
+};
+
+RunMonitor::RunMonitor(const CancellationToken& tokenIn, const double maxWallTime) :
+	stopRequested(false),
+	token(tokenIn),
+	deadline(std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+		std::chrono::duration<double>(std::isfinite(maxWallTime) ? maxWallTime : 0.0))),
+	hasDeadline(std::isfinite(maxWallTime))
+{
+	//Nothing else to do here
+}
+
+/// <summary>
+/// Check the stop flag first, then the token, then the clock
+/// </summary>
+/// <returns></returns>
+bool RunMonitor::isStopRequested() const
+{
+	return stopRequested.load(std::memory_order_acquire) || token.isCancelled() || (hasDeadline && std::chrono::steady_clock::now() >= deadline);
+}
+
+/// <summary>
+/// The method is out of the race so its projection is dropped
+/// </summary>
+/// <param name="methodId"></param>
+void RunMonitor::methodFinished(const unsigned int methodId)
+{
+	unique_lock<mutex> lock(monitorLock);
+	projectedFinish.erase(methodId);
+}
+
+/// <summary>
+/// Save the methods projected finish time. The method is projected to lose when another method is projected to finish
+/// faster by more than the loss factor. The leading method never loses so the race always has someone left running.
+/// </summary>
+/// <param name="methodId"></param>
+/// <param name="projectedTime"></param>
+/// <param name="lossFactor"></param>
+/// <returns></returns>
+bool RunMonitor::isProjectedToLose(const unsigned int methodId, const double projectedTime, const double lossFactor)
+{
+	unique_lock<mutex> lock(monitorLock);
+
+	//Save our projection
+	projectedFinish[methodId] = projectedTime;
+
+	//Find the best projection of everyone else
+	double bestOther = std::numeric_limits<double>::infinity();
+	for (const auto& projection : projectedFinish)
+	{
+		if (projection.first != methodId)
+		{
+			bestOther = std::min(bestOther, projection.second);
+		}
+	}
+
+	return std::isfinite(bestOther) && projectedTime > lossFactor * bestOther;
+}
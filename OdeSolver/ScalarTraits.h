@@ -0,0 +1,36 @@
+#pragma once
+
+#include <valarray>
+
+using std::valarray;
+
+// Traits for the scalar the state and stages are stored in and the scalar the richardson extrapolation and error norms are accumulated in.
+template <typename StateScalar, typename AccumulateScalar>
+struct ScalarTraits
+{
+	//Scalar for states, stages, and results
+	using state = StateScalar;
+
+	//Scalar for the richardson tables and error norms
+	using accumulate = AccumulateScalar;
+};
+
+// Pick the precision at build time. 
+// ODESOLVER_SINGLE_PRECISION runs everything in float.
+// ODESOLVER_MIXED_PRECISION stores the state and stages as float but extrapolates and measures the error in double.
+#if defined(ODESOLVER_SINGLE_PRECISION)
+using precision = ScalarTraits<float, float>;
+#elif defined(ODESOLVER_MIXED_PRECISION)
+using precision = ScalarTraits<float, double>;
+#else
+using precision = ScalarTraits<double, double>;
+#endif
+
+//Convience for writing out methods
+using scalar = precision::state;
+using accScalar = precision::accumulate;
+using vec = valarray<scalar>;
+using accVec = valarray<accScalar>;
+
+//Times and step sizes always stay in double
+using timeVec = valarray<double>;
@@ -0,0 +1,313 @@
+#include "ShardedEnsemble.h"
+
+#if defined(_WIN32)
+#error "ShardedEnsemble needs POSIX fork and shared memory"
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <iostream>
+#include <new>
+#include <thread>
+
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/// <summary>
+/// Save the configuration. Nothing is mapped until the first run.
+/// </summary>
+/// <param name="paramsIn"></param>
+/// <param name="processesIn"></param>
+/// <param name="chunkSizeIn"></param>
+/// <param name="maxRestartsIn"></param>
+ShardedEnsemble::ShardedEnsemble(const OdeSolverParams& paramsIn, const size_t processesIn, const size_t chunkSizeIn, const size_t maxRestartsIn) :
+	ensembleParams(paramsIn),
+	processes(processesIn),
+	chunkSize(chunkSizeIn),
+	maxRestarts(maxRestartsIn),
+	sharedBuffer(nullptr),
+	sharedBytes(0),
+	members(0),
+	components(0),
+	samples(0),
+	memberDone(nullptr),
+	memberErrors(nullptr),
+	sampleTimes(nullptr),
+	columns(nullptr),
+	restarts(0)
+{
+	//Check we have someone to do the work
+	if (processes == 0 || chunkSize == 0)
+	{
+		throw invalid_argument("Need at least one process and one member per chunk");
+	}
+}
+
+/// <summary>
+/// Give the shared buffer back
+/// </summary>
+ShardedEnsemble::~ShardedEnsemble()
+{
+	unmapBuffer();
+}
+
+/// <summary>
+/// Map one anonymous shared buffer (inherited by the workers we fork) and cut it into the done flags, errors, times, and columns.
+/// Each section starts on its own cache line.
+/// </summary>
+/// <param name="membersIn"></param>
+/// <param name="componentsIn"></param>
+/// <param name="samplesIn"></param>
+void ShardedEnsemble::mapBuffer(const size_t membersIn, const size_t componentsIn, const size_t samplesIn)
+{
+	//Drop the last runs buffer
+	unmapBuffer();
+
+	//Round each section up to a cache line
+	const auto padded = [](const size_t bytes) { return (bytes + 63) / 64 * 64; };
+	const size_t doneBytes = padded(membersIn * sizeof(atomic<int>));
+	const size_t errorBytes = padded(membersIn * sizeof(double));
+	const size_t timeBytes = padded(samplesIn * sizeof(double));
+	const size_t columnBytes = padded(membersIn * componentsIn * samplesIn * sizeof(scalar));
+
+	//Map the buffer
+	sharedBytes = doneBytes + errorBytes + timeBytes + columnBytes;
+	void* buffer = mmap(nullptr, sharedBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (buffer == MAP_FAILED)
+	{
+		sharedBytes = 0;
+		throw runtime_error("Could not map the shared ensemble buffer");
+	}
+	sharedBuffer = buffer;
+
+	//Lay out the views
+	char* base = static_cast<char*>(sharedBuffer);
+	memberDone = new (base) atomic<int>[membersIn];
+	memberErrors = reinterpret_cast<double*>(base + doneBytes);
+	sampleTimes = reinterpret_cast<double*>(base + doneBytes + errorBytes);
+	columns = reinterpret_cast<scalar*>(base + doneBytes + errorBytes + timeBytes);
+
+	//Nobody is done yet
+	for (size_t member = 0; member < membersIn; ++member)
+	{
+		memberDone[member].store(0, std::memory_order_relaxed);
+	}
+
+	members = membersIn;
+	components = componentsIn;
+	samples = samplesIn;
+}
+
+/// <summary>
+/// Unmap the buffer if we have one
+/// </summary>
+void ShardedEnsemble::unmapBuffer()
+{
+	if (sharedBuffer != nullptr)
+	{
+		munmap(sharedBuffer, sharedBytes);
+	}
+
+	sharedBuffer = nullptr;
+	sharedBytes = 0;
+	memberDone = nullptr;
+	memberErrors = nullptr;
+	sampleTimes = nullptr;
+	columns = nullptr;
+	members = 0;
+	components = 0;
+	samples = 0;
+}
+
+/// <summary>
+/// Solve the members of the shard that are not done in chunks, sampling each chunk into the columns before flagging its members done
+/// </summary>
+/// <param name="problem"></param>
+/// <param name="initalConditions"></param>
+/// <param name="shardBegin"></param>
+/// <param name="shardEnd"></param>
+void ShardedEnsemble::solveShard(const OdeFunIF* problem, const vector<vec>& initalConditions, const size_t shardBegin, const size_t shardEnd)
+{
+	OdeSolver solver(ensembleParams);
+	vector<vec> chunkConditions;
+	vector<size_t> chunkMembers;
+
+	size_t member = shardBegin;
+	while (member < shardEnd)
+	{
+		//Gather the next chunk of members still to do
+		chunkConditions.clear();
+		chunkMembers.clear();
+		for (; member < shardEnd && chunkMembers.size() < chunkSize; ++member)
+		{
+			if (!isMemberDone(member))
+			{
+				chunkConditions.push_back(initalConditions[member]);
+				chunkMembers.push_back(member);
+			}
+		}
+		if (chunkMembers.empty())
+		{
+			continue;
+		}
+
+		//Solve the chunk in lockstep
+		solver.runEnsemble(problem, chunkConditions, sampleTimes[0], sampleTimes[samples - 1]);
+
+		//Write each member into the columns and only then flag it done
+		for (size_t i = 0; i < chunkMembers.size(); ++i)
+		{
+			const size_t currentMember = chunkMembers[i];
+			for (size_t sample = 0; sample < samples; ++sample)
+			{
+				const StateVector sampled = solver.getEnsembleStateAndTime(i, sampleTimes[sample]);
+				for (size_t component = 0; component < components; ++component)
+				{
+					columns[(component * samples + sample) * members + currentMember] = sampled.getState()[component];
+				}
+			}
+			memberErrors[currentMember] = solver.getEnsembleResults(i).back().getParams().totalError;
+			memberDone[currentMember].store(1, std::memory_order_release);
+		}
+	}
+}
+
+/// <summary>
+/// Fork one worker per shard and wait for them. A worker that crashes or fails is forked again on the same shard
+/// (skipping the members it already finished) until the shard runs out of restarts.
+/// </summary>
+/// <param name="problem"></param>
+/// <param name="initalConditions"></param>
+/// <param name="beginTime"></param>
+/// <param name="endTime"></param>
+/// <param name="samplesIn"></param>
+void ShardedEnsemble::run(const OdeFunIF* problem, const vector<vec>& initalConditions, const double beginTime, const double endTime, const size_t samplesIn)
+{
+	//Check the inputs
+	if (initalConditions.empty() || samplesIn < 2 || !(endTime > beginTime))
+	{
+		throw invalid_argument("Need members, at least two samples, and an end time after the begin time");
+	}
+	for (const vec& initalCondition : initalConditions)
+	{
+		if (initalCondition.size() != initalConditions.front().size())
+		{
+			throw invalid_argument("Every member needs the same number of components");
+		}
+	}
+
+	//Build our shared buffer and the sample times
+	mapBuffer(initalConditions.size(), initalConditions.front().size(), samplesIn);
+	for (size_t sample = 0; sample < samples; ++sample)
+	{
+		sampleTimes[sample] = beginTime + (endTime - beginTime) * static_cast<double>(sample) / static_cast<double>(samples - 1);
+	}
+	sampleTimes[samples - 1] = endTime;
+	restarts = 0;
+
+	//Cut the members into contiguous shards
+	const size_t shards = std::min(processes, members);
+	vector<pid_t> workers(shards, -1);
+	vector<size_t> shardRestarts(shards, 0);
+	const auto shardBegin = [this, shards](const size_t shard) { return shard * members / shards; };
+
+	//Fork a worker on a shard
+	const auto startWorker = [&](const size_t shard)
+	{
+		std::cout.flush();
+		std::cerr.flush();
+
+		const pid_t pid = fork();
+		if (pid < 0)
+		{
+			throw runtime_error("Could not fork an ensemble worker");
+		}
+
+		//The worker solves its shard and leaves without running the parents destructors
+		if (pid == 0)
+		{
+			int status = 0;
+			try
+			{
+				solveShard(problem, initalConditions, shardBegin(shard), shardBegin(shard + 1));
+			}
+			catch (exception& e)
+			{
+				cerr << e.what();
+				status = 1;
+			}
+			std::cout.flush();
+			std::cerr.flush();
+			_exit(status);
+		}
+
+		workers[shard] = pid;
+	};
+
+	//Start everyone
+	for (size_t shard = 0; shard < shards; ++shard)
+	{
+		startWorker(shard);
+	}
+
+	//Reap the next of our workers to finish (only our own pids, so other children of the host process are left alone)
+	const auto reapWorker = [&](int& status)
+	{
+		while (true)
+		{
+			for (size_t shard = 0; shard < shards; ++shard)
+			{
+				if (workers[shard] <= 0)
+				{
+					continue;
+				}
+
+				//A worker we can no longer wait on counts as failed
+				const pid_t reaped = waitpid(workers[shard], &status, WNOHANG);
+				if (reaped == workers[shard] || (reaped < 0 && errno != EINTR))
+				{
+					status = reaped < 0 ? -1 : status;
+					workers[shard] = -1;
+					return shard;
+				}
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	};
+
+	//Wait for the workers, restarting the ones that did not finish their shard
+	bool hasFailed = false;
+	size_t running = shards;
+	while (running > 0)
+	{
+		int status = 0;
+		const size_t shard = reapWorker(status);
+
+		//Check every member of the shard got done
+		bool shardDone = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+		for (size_t member = shardBegin(shard); member < shardBegin(shard + 1); ++member)
+		{
+			shardDone &= isMemberDone(member);
+		}
+
+		//Go again on what is left if we can
+		if (!shardDone && shardRestarts[shard] < maxRestarts)
+		{
+			++shardRestarts[shard];
+			++restarts;
+			startWorker(shard);
+			continue;
+		}
+
+		hasFailed |= !shardDone;
+		--running;
+	}
+
+	//Let the caller know some members never finished
+	if (hasFailed)
+	{
+		throw runtime_error("An ensemble shard failed after its restarts");
+	}
+}
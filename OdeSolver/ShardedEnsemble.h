@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "OdeFunIF.h"
+#include "OdeSolver.h"
+#include "OdeSolverParams.h"
+
+using std::atomic;
+using std::invalid_argument;
+using std::runtime_error;
+using std::vector;
+
+// Class to split a large ensemble across several local worker processes.
+// The members are cut into one contiguous shard per process and each process solves its shard in chunks with runEnsemble.
+// Every chunk is sampled on a fixed time grid straight into a shared memory buffer laid out by column: for each component and
+// sample time the members sit next to each other. The parent reads the columns in place without copying them.
+// A member is flagged done once its chunk is written so a worker that crashes can be started again on just the members it had left.
+// This needs POSIX fork and shared memory (a worker inherits the problem from the parent) so it is left out of the Visual Studio projects
+// and only builds on POSIX systems.
+class ShardedEnsemble
+{
+private:
+
+	//Configuration every member is solved with
+	OdeSolverParams ensembleParams;
+
+	//Number of worker processes
+	const size_t processes;
+
+	//Most members a worker packs into one runEnsemble call
+	const size_t chunkSize;
+
+	//Most times each shard may be restarted after its worker crashed
+	const size_t maxRestarts;
+
+	//The shared buffer and its size in bytes
+	void* sharedBuffer;
+	size_t sharedBytes;
+
+	//Layout of the last run
+	size_t members;
+	size_t components;
+	size_t samples;
+
+	//Views into the shared buffer
+	atomic<int>* memberDone;
+	double* memberErrors;
+	double* sampleTimes;
+	scalar* columns;
+
+	//Restarts the last run needed
+	size_t restarts;
+
+	//Map a buffer big enough for the run and lay out the views
+	void mapBuffer(const size_t, const size_t, const size_t);
+
+	//Unmap the buffer
+	void unmapBuffer();
+
+	//Solve the members of a shard that are not done yet (runs in the worker process)
+	void solveShard(const OdeFunIF*, const vector<vec>&, const size_t, const size_t);
+
+public:
+
+	//Build with the configuration, the number of processes, members per chunk, and restarts allowed per shard
+	ShardedEnsemble(const OdeSolverParams&, const size_t, const size_t = 64, const size_t = 1);
+
+	//Can not copy the shared buffer
+	ShardedEnsemble(const ShardedEnsemble&) = delete;
+	ShardedEnsemble& operator=(const ShardedEnsemble&) = delete;
+
+	//Unmap the shared buffer
+	~ShardedEnsemble();
+
+	//Solve every inital condition from the begin to the end time sampling each at the number of evenly spaced times (at least two).
+	//Throws once every worker is done if a shard still failed after its restarts, the members that finished can still be read.
+	void run(const OdeFunIF*, const vector<vec>&, const double, const double, const size_t);
+
+	//Get the sample times
+	inline const double* getSampleTimes() const { return sampleTimes; };
+
+	//Get the column of one component at one sample time holding every member in order
+	inline const scalar* getColumn(const size_t component, const size_t sample) const { return columns + (component * samples + sample) * members; };
+
+	//Get one component of one member at one sample time
+	inline scalar getValue(const size_t member, const size_t component, const size_t sample) const { return getColumn(component, sample)[member]; };
+
+	//Check if a member was solved
+	inline bool isMemberDone(const size_t member) const { return memberDone[member].load(std::memory_order_acquire) != 0; };
+
+	//Get the total error the best method reached for a member
+	inline double getMemberError(const size_t member) const { return memberErrors[member]; };
+
+	//Get the sizes of the last run
+	inline size_t getMemberCount() const { return members; };
+	inline size_t getComponentCount() const { return components; };
+	inline size_t getSampleCount() const { return samples; };
+
+	//Get the number of worker restarts the last run needed
+	inline size_t getRestarts() const { return restarts; };
+};
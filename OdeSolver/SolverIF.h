@@ -8,9 +8,10 @@
 //Convience for writing out methods
 using std::logic_error;
 using std::valarray;
-using vec = valarray<double>;
+using vec = valarray<scalar>;
 using crvec = const vec&;
 using rvec = vec&;
+using maskVec = valarray<bool>;
 
 class SolverIF
 {
@@ -25,6 +26,13 @@ protected:
 	//Method to update the next time step
 	inline void updateTimeStep(const double& dt, double& currentTime) { currentTime += dt; };
 
+	//Set out to x + a * y one element at a time so stage updates never build temporaries (works for states and times)
+	template <typename T>
+	inline static void addScaled(valarray<T>& out, const valarray<T>& x, const double a, const valarray<T>& y) { for (size_t i = 0; i < out.size(); ++i) { out[i] = static_cast<T>(x[i] + a * y[i]); } };
+
+	//Set out to x + a * dt * y where dt lines up with x (packed ensembles)
+	inline static void addScaled(rvec out, crvec x, const double a, crvec dt, crvec y) { for (size_t i = 0; i < out.size(); ++i) { out[i] = static_cast<scalar>(x[i] + a * dt[i] * y[i]); } };
+
 private:
 
 	//Method for all members to initalze their solving helper vectors
@@ -63,6 +71,9 @@ public:
 	//For implict methods
 	virtual rvec update(crvec, rvec, const double&, const double&, const int&, const OdeFunIF*, const double&, const double&) = 0;
 
+	//For packed ensembles where each active member steps with its own dt and time
+	virtual rvec update(crvec, rvec, const timeVec&, const timeVec&, const int&, const maskVec&, const OdeFunIF*) = 0;
+
 	//Get the power of the error
 	virtual const double getErrorOrder() const = 0;
 
@@ -5,7 +5,7 @@
 #include <valarray>
 
 using std::valarray;
-using vec = valarray<double>;
+using vec = valarray<scalar>;
 
 class StateVector
 {
@@ -20,10 +20,10 @@ private:
 public:
 
 	//Constructor with copy
-	inline StateVector(const valarray<double>&, const OdeSolverParams&);
+	inline StateVector(const vec&, const OdeSolverParams&);
 
 	//Constructor with move
-	inline StateVector(valarray<double>&&, OdeSolverParams&&);
+	inline StateVector(vec&&, OdeSolverParams&&);
 
 	//Using default Copy Constructor
 	inline StateVector(const StateVector&) = default;
@@ -46,6 +46,12 @@ public:
 	//Get the parameters
 	inline const OdeSolverParams& getParams() const { return currentParams; };
 
+	//Write a new state and parameters over ours in place (the state must be the same size so nothing is allocated)
+	inline void assign(const vec& stateIn, const OdeSolverParams& paramsIn) { currentState = stateIn; currentParams = paramsIn; };
+
+	//Mark the state as the end of a run that stopped before its end time
+	inline void markPartial() { currentParams.isPartial = true; };
+
 };
 
 /// <summary>
@@ -53,7 +59,7 @@ public:
 /// </summary>
 /// <param name="currentStateIn"></param>
 /// <param name="currentParamsIn"></param>
-StateVector::StateVector(const valarray<double>& currentStateIn, const OdeSolverParams& currentParamsIn) :
+StateVector::StateVector(const vec& currentStateIn, const OdeSolverParams& currentParamsIn) :
 	currentState(currentStateIn),
 	currentParams(currentParamsIn)
 {
@@ -65,9 +71,9 @@ StateVector::StateVector(const valarray<double>& currentStateIn, const OdeSolver
 /// </summary>
 /// <param name="currentStateIn"></param>
 /// <param name="currentParamsIn"></param>
-StateVector::StateVector(valarray<double>&& currentStateIn, OdeSolverParams&& currentParamsIn) :
-	currentState(currentStateIn),
-	currentParams(currentParamsIn)
+StateVector::StateVector(vec&& currentStateIn, OdeSolverParams&& currentParamsIn) :
+	currentState(std::move(currentStateIn)),
+	currentParams(std::move(currentParamsIn))
 {
 	//Nothing else to do here
 }
@@ -0,0 +1,184 @@
+#include "StepObserver.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+/// <summary>
+/// Save the stream and the interval in nanoseconds
+/// </summary>
+/// <param name="outIn"></param>
+/// <param name="intervalSeconds"></param>
+ConsoleStepObserver::ConsoleStepObserver(ostream& outIn, const double intervalSeconds) :
+	out(outIn),
+	interval(static_cast<long long>(std::max(intervalSeconds, 0.0) * 1e9)),
+	beginTime(0.0),
+	endTime(0.0),
+	earliestPrint(0)
+{
+	//Nothing else to do here
+}
+
+/// <summary>
+/// Save the interval for the percentages and make every method wait one interval before its first line
+/// </summary>
+/// <param name="beginTimeIn"></param>
+/// <param name="endTimeIn"></param>
+/// <param name="methodIds"></param>
+void ConsoleStepObserver::runStarted(const double beginTimeIn, const double endTimeIn, const vector<unsigned int>& methodIds)
+{
+	std::lock_guard<mutex> lock(printLock);
+	beginTime = beginTimeIn;
+	endTime = endTimeIn;
+
+	//Everyone is first due one interval in
+	const long long firstPrint = now() + interval;
+	nextPrint.clear();
+	for (const unsigned int methodId : methodIds)
+	{
+		nextPrint[methodId] = firstPrint;
+	}
+	earliestPrint.store(firstPrint, std::memory_order_relaxed);
+}
+
+/// <summary>
+/// Skip the step unless some method is due, then print it if this method is due and work out who is due next
+/// </summary>
+/// <param name="methodId"></param>
+/// <param name="record"></param>
+void ConsoleStepObserver::stepAccepted(const unsigned int methodId, const ProgressRecord& record)
+{
+	//Nobody is due yet
+	const long long currentTime = now();
+	if (currentTime < earliestPrint.load(std::memory_order_relaxed))
+	{
+		return;
+	}
+
+	std::lock_guard<mutex> lock(printLock);
+
+	//Check if we are due (a method we were not told about is due right away)
+	const map<unsigned int, long long>::const_iterator methodPrint = nextPrint.find(methodId);
+	if (methodPrint != nextPrint.cend() && currentTime < methodPrint->second)
+	{
+		return;
+	}
+
+	printProgress(methodId, record);
+	nextPrint[methodId] = currentTime + interval;
+
+	//Find the next method due
+	long long earliest = std::numeric_limits<long long>::max();
+	for (const auto& methodTime : nextPrint)
+	{
+		earliest = std::min(earliest, methodTime.second);
+	}
+	earliestPrint.store(earliest, std::memory_order_relaxed);
+}
+
+/// <summary>
+/// Print the final line of every method
+/// </summary>
+/// <param name="records"></param>
+void ConsoleStepObserver::runCompleted(const map<unsigned int, ProgressRecord>& records)
+{
+	std::lock_guard<mutex> lock(printLock);
+	for (const auto& record : records)
+	{
+		printProgress(record.first, record.second);
+	}
+}
+
+/// <summary>
+/// Print how far along the method is, the wall time it has left at its current pace, and its error, dt, and table size
+/// </summary>
+/// <param name="methodId"></param>
+/// <param name="record"></param>
+void ConsoleStepObserver::printProgress(const unsigned int methodId, const ProgressRecord& record)
+{
+	//Compute calculations to print
+	const double percentDone = 100 * std::fabs((record.currentTime - beginTime) / (endTime - beginTime));
+	const double remainingTime = percentDone > 0.0 ? (record.totalTime / (.01 * percentDone)) * (endTime - record.currentTime) : 0.0;
+
+	out << std::setprecision(4) << std::setw(2) << "{" << methodId << ":\t" << "CurrentTime: " << record.currentTime << "; " << percentDone << "% Done; Remaining Time: "
+		<< std::max(remainingTime, 0.0) << "; TotalError: " << record.totalError << "; Step Size: " << record.dt << "; NumLevels: " << record.currentTableSize << "}" << std::endl;
+}
+
+MetricsStepObserver::MetricsStepObserver() :
+	completedRuns(0)
+{
+	//Nothing else to do here
+}
+
+/// <summary>
+/// Count the step and track the dt range, time, and error
+/// </summary>
+/// <param name="methodId"></param>
+/// <param name="record"></param>
+void MetricsStepObserver::stepAccepted(const unsigned int methodId, const ProgressRecord& record)
+{
+	std::lock_guard<mutex> lock(metricsLock);
+	StepMetrics& methodMetrics = metrics[methodId];
+	++methodMetrics.acceptedSteps;
+	methodMetrics.smallestDt = std::min(methodMetrics.smallestDt, record.dt);
+	methodMetrics.largestDt = std::max(methodMetrics.largestDt, record.dt);
+	methodMetrics.currentTime = record.currentTime;
+	methodMetrics.totalError = record.totalError;
+}
+
+/// <summary>
+/// Count the table and track the worst error we threw away
+/// </summary>
+/// <param name="methodId"></param>
+/// <param name="time"></param>
+/// <param name="dt"></param>
+/// <param name="error"></param>
+void MetricsStepObserver::stepRejected(const unsigned int methodId, const double, const double, const double error)
+{
+	std::lock_guard<mutex> lock(metricsLock);
+	StepMetrics& methodMetrics = metrics[methodId];
+	++methodMetrics.rejectedSteps;
+	methodMetrics.worstRejectedError = std::max(methodMetrics.worstRejectedError, error);
+}
+
+/// <summary>
+/// Count the run
+/// </summary>
+/// <param name="records"></param>
+void MetricsStepObserver::runCompleted(const map<unsigned int, ProgressRecord>&)
+{
+	std::lock_guard<mutex> lock(metricsLock);
+	++completedRuns;
+}
+
+/// <summary>
+/// Copy out the counters of the method
+/// </summary>
+/// <param name="methodId"></param>
+/// <returns></returns>
+StepMetrics MetricsStepObserver::getMetrics(const unsigned int methodId) const
+{
+	std::lock_guard<mutex> lock(metricsLock);
+	const map<unsigned int, StepMetrics>::const_iterator methodMetrics = metrics.find(methodId);
+	return methodMetrics == metrics.cend() ? StepMetrics() : methodMetrics->second;
+}
+
+/// <summary>
+/// Get the number of runs we saw complete
+/// </summary>
+/// <returns></returns>
+size_t MetricsStepObserver::getCompletedRuns() const
+{
+	std::lock_guard<mutex> lock(metricsLock);
+	return completedRuns;
+}
+
+/// <summary>
+/// Drop every counter
+/// </summary>
+void MetricsStepObserver::clear()
+{
+	std::lock_guard<mutex> lock(metricsLock);
+	metrics.clear();
+	completedRuns = 0;
+}
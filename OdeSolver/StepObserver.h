@@ -0,0 +1,150 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "ProgressSlot.h"
+
+using std::atomic;
+using std::map;
+using std::mutex;
+using std::ostream;
+using std::vector;
+
+// Interface the solver tells about the steps of a run so the caller decides what to report and where.
+// The step callbacks are made on the method threads, several methods at once, so an observer has to be thread safe.
+// Every callback does nothing by default so an observer only overrides what it wants.
+class StepObserver
+{
+public:
+
+	//Default Delete operator
+	virtual ~StepObserver() = default;
+
+	//A run is starting over the interval with the methods
+	inline virtual void runStarted(const double, const double, const vector<unsigned int>&) {};
+
+	//A method accepted a step, the record holds where it got to
+	inline virtual void stepAccepted(const unsigned int, const ProgressRecord&) {};
+
+	//A method threw away a table at the time, the dt it tried, and the error it got
+	inline virtual void stepRejected(const unsigned int, const double, const double, const double) {};
+
+	//Every method of the run is done, the records hold where each one ended up
+	inline virtual void runCompleted(const map<unsigned int, ProgressRecord>&) {};
+};
+
+// Observer that ignores everything (the same as not setting an observer at all)
+class NullStepObserver : public StepObserver
+{
+};
+
+// Observer that prints each methods progress to a stream at most once per interval per method and a summary when the run is done.
+// A step that comes in before any method is due only costs a clock read and an atomic load.
+class ConsoleStepObserver : public StepObserver
+{
+private:
+
+	//Where we print
+	ostream& out;
+
+	//Nanoseconds between the lines of one method
+	const long long interval;
+
+	//The interval of the run
+	double beginTime;
+	double endTime;
+
+	//Guards the print times and the stream
+	mutex printLock;
+
+	//When each method may print next
+	map<unsigned int, long long> nextPrint;
+
+	//Earliest time any method may print next
+	atomic<long long> earliestPrint;
+
+	//Get the time in nanoseconds
+	inline static long long now() { return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count(); };
+
+	//Print a methods progress line
+	void printProgress(const unsigned int, const ProgressRecord&);
+
+public:
+
+	//Print to the stream (standard out by default) every number of seconds
+	ConsoleStepObserver(ostream& = std::cout, const double = 2.0);
+
+	//Remember the interval and hold every method off for one interval
+	virtual void runStarted(const double, const double, const vector<unsigned int>&) override;
+
+	//Print the step if the method is due
+	virtual void stepAccepted(const unsigned int, const ProgressRecord&) override;
+
+	//Print where every method ended up
+	virtual void runCompleted(const map<unsigned int, ProgressRecord>&) override;
+};
+
+// Counters the metrics observer keeps for each method
+struct StepMetrics
+{
+	//Steps accepted and tables thrown away
+	size_t acceptedSteps = 0;
+	size_t rejectedSteps = 0;
+
+	//Smallest and largest dt of the accepted steps
+	double smallestDt = std::numeric_limits<double>::infinity();
+	double largestDt = 0.0;
+
+	//Largest error of a rejected table
+	double worstRejectedError = 0.0;
+
+	//Where the method got to and the error it built up
+	double currentTime = 0.0;
+	double totalError = 0.0;
+};
+
+// Observer that adds the steps of each method up into counters without printing anything.
+// The counters build up over every run it watches until they are cleared.
+class MetricsStepObserver : public StepObserver
+{
+private:
+
+	//Guards the counters
+	mutable mutex metricsLock;
+
+	//The counters of each method
+	map<unsigned int, StepMetrics> metrics;
+
+	//Number of runs that completed
+	size_t completedRuns;
+
+public:
+
+	//Start with no counters
+	MetricsStepObserver();
+
+	//Count the accepted step
+	virtual void stepAccepted(const unsigned int, const ProgressRecord&) override;
+
+	//Count the rejected table
+	virtual void stepRejected(const unsigned int, const double, const double, const double) override;
+
+	//Count the run
+	virtual void runCompleted(const map<unsigned int, ProgressRecord>&) override;
+
+	//Get a copy of a methods counters (empty counters if it was never seen)
+	StepMetrics getMetrics(const unsigned int) const;
+
+	//Get the number of runs that completed
+	size_t getCompletedRuns() const;
+
+	//Drop every counter
+	void clear();
+};
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+
+#include "StateVector.h"
+
+using std::condition_variable;
+using std::deque;
+using std::exception_ptr;
+using std::mutex;
+using std::unique_lock;
+
+// One accepted step and the method that produced it
+struct StreamedStep
+{
+	//Method the step came from
+	unsigned int methodId;
+
+	//The accepted state and its parameters
+	StateVector step;
+};
+
+// Bounded queue the method threads push accepted steps into while a consumer pops them.
+// A full queue blocks the method threads so a slow consumer holds the memory use to the capacity.
+class StepQueue
+{
+private:
+
+	//Guards the steps, the closed flag, and the failure
+	mutex queueLock;
+
+	//Signaled when a step is pushed or the queue is closed
+	condition_variable notEmpty;
+
+	//Signaled when a step is popped or the queue is closed
+	condition_variable notFull;
+
+	//The steps waiting on the consumer
+	deque<StreamedStep> steps;
+
+	//Most steps we hold before blocking the method threads
+	const size_t capacity;
+
+	//Flag once nothing else will be pushed
+	bool isClosed;
+
+	//Error the producer closed the queue with (null if it finished cleanly)
+	exception_ptr failure;
+
+public:
+
+	//Build the queue with its capacity
+	inline StepQueue(const size_t);
+
+	//Can not copy or move the synchronization
+	StepQueue(const StepQueue&) = delete;
+	StepQueue& operator=(const StepQueue&) = delete;
+
+	//Default Delete operator
+	inline ~StepQueue() = default;
+
+	//Push a step, waiting while the queue is full. Returns false if the queue was closed.
+	inline bool push(const unsigned int, const StateVector&);
+
+	//Pop the next step, waiting while the queue is empty. Returns false once the queue is closed and empty.
+	inline bool pop(StreamedStep&);
+
+	//Close the queue waking everyone waiting on it. A producer that failed passes its error along.
+	inline void close(const exception_ptr& = nullptr);
+
+	//Get the error the queue was closed with (null if none)
+	inline exception_ptr getFailure();
+};
+
+StepQueue::StepQueue(const size_t capacityIn) :
+	capacity(capacityIn > 0 ? capacityIn : 1),
+	isClosed(false)
+{
+	//Nothing else to do here
+}
+
+/// <summary>
+/// Push the step for the method once there is room
+/// </summary>
+/// <param name="methodId"></param>
+/// <param name="step"></param>
+/// <returns></returns>
+bool StepQueue::push(const unsigned int methodId, const StateVector& step)
+{
+	{
+		unique_lock<mutex> lock(queueLock);
+
+		//Wait for room
+		notFull.wait(lock, [this]() { return isClosed || steps.size() < capacity; });
+
+		//Nobody is listening anymore
+		if (isClosed)
+		{
+			return false;
+		}
+
+		steps.push_back(StreamedStep{ methodId, step });
+	}
+
+	notEmpty.notify_one();
+	return true;
+}
+
+/// <summary>
+/// Move the next step out once there is one
+/// </summary>
+/// <param name="next"></param>
+/// <returns></returns>
+bool StepQueue::pop(StreamedStep& next)
+{
+	{
+		unique_lock<mutex> lock(queueLock);
+
+		//Wait for a step
+		notEmpty.wait(lock, [this]() { return isClosed || !steps.empty(); });
+
+		//Closed and drained
+		if (steps.empty())
+		{
+			return false;
+		}
+
+		next = std::move(steps.front());
+		steps.pop_front();
+	}
+
+	notFull.notify_one();
+	return true;
+}
+
+/// <summary>
+/// Close the queue. The steps already in it can still be popped.
+/// The error is stored under the same lock so anyone who sees the queue closed also sees it.
+/// </summary>
+/// <param name="error"></param>
+void StepQueue::close(const exception_ptr& error)
+{
+	{
+		unique_lock<mutex> lock(queueLock);
+		isClosed = true;
+
+		//Keep the first error, a later clean close does not clear it
+		if (error && !failure)
+		{
+			failure = error;
+		}
+	}
+
+	notEmpty.notify_all();
+	notFull.notify_all();
+}
+
+/// <summary>
+/// Get the error the producer closed the queue with
+/// </summary>
+/// <returns></returns>
+exception_ptr StepQueue::getFailure()
+{
+	unique_lock<mutex> lock(queueLock);
+	return failure;
+}
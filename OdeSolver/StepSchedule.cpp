@@ -0,0 +1,136 @@
+#include "StepSchedule.h"
+
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <utility>
+
+/// <summary>
+/// Find the recorded step that ends first after the time and aim for where it ends, so a run that took the same steps replays them
+/// exactly and a run that fell off the schedule gets back onto it. If that leaves less than half of the recorded step we aim for the
+/// end of the next one instead of taking a sliver.
+/// </summary>
+/// <param name="methodId"></param>
+/// <param name="time"></param>
+/// <param name="cursor"></param>
+/// <param name="step"></param>
+/// <returns></returns>
+const bool StepSchedule::findStep(const unsigned int methodId, const double time, size_t& cursor, ScheduledStep& step) const
+{
+	//Check the method has a schedule
+	const map<unsigned int, vector<ScheduledStep>>::const_iterator methodSteps = steps.find(methodId);
+	if (methodSteps == steps.cend())
+	{
+		return false;
+	}
+	const vector<ScheduledStep>& schedule = methodSteps->second;
+
+	//Skip the steps that end before the time
+	while (cursor < schedule.size() && schedule[cursor].time + schedule[cursor].dt <= time)
+	{
+		++cursor;
+	}
+	if (cursor == schedule.size())
+	{
+		return false;
+	}
+
+	//Do not take a sliver to get back onto the schedule
+	if (schedule[cursor].time + schedule[cursor].dt - time < .5 * schedule[cursor].dt && cursor + 1 < schedule.size())
+	{
+		++cursor;
+	}
+
+	//Aim for the end of the step
+	step.time = time;
+	step.dt = schedule[cursor].time + schedule[cursor].dt - time;
+	step.tableSize = schedule[cursor].tableSize;
+
+	return true;
+}
+
+/// <summary>
+/// Get the steps a method recorded
+/// </summary>
+/// <param name="methodId"></param>
+/// <returns></returns>
+const vector<ScheduledStep>& StepSchedule::getSteps(const unsigned int methodId) const
+{
+	static const vector<ScheduledStep> noSteps;
+
+	const map<unsigned int, vector<ScheduledStep>>::const_iterator methodSteps = steps.find(methodId);
+	return methodSteps == steps.cend() ? noSteps : methodSteps->second;
+}
+
+/// <summary>
+/// Check if any method has a step
+/// </summary>
+/// <returns></returns>
+const bool StepSchedule::empty() const
+{
+	for (const auto& methodSteps : steps)
+	{
+		if (!methodSteps.second.empty())
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/// <summary>
+/// Write a line per step with the times at full precision so a loaded schedule lands on the same times
+/// </summary>
+/// <param name="fileName"></param>
+/// <returns></returns>
+bool StepSchedule::save(const string& fileName) const
+{
+	std::ofstream file(fileName);
+	if (!file)
+	{
+		return false;
+	}
+
+	file << std::setprecision(std::numeric_limits<double>::max_digits10);
+	for (const auto& methodSteps : steps)
+	{
+		for (const ScheduledStep& step : methodSteps.second)
+		{
+			file << methodSteps.first << " " << step.time << " " << step.dt << " " << step.tableSize << "\n";
+		}
+	}
+
+	return static_cast<bool>(file);
+}
+
+/// <summary>
+/// Read the lines back in, keeping this schedule as it was if the file can not be opened or a line is bad
+/// </summary>
+/// <param name="fileName"></param>
+/// <returns></returns>
+bool StepSchedule::load(const string& fileName)
+{
+	std::ifstream file(fileName);
+	if (!file)
+	{
+		return false;
+	}
+
+	map<unsigned int, vector<ScheduledStep>> loadedSteps;
+	unsigned int methodId = 0;
+	ScheduledStep step;
+	while (file >> methodId >> step.time >> step.dt >> step.tableSize)
+	{
+		loadedSteps[methodId].push_back(step);
+	}
+
+	//Make sure we stopped at the end and not on a bad line
+	if (!file.eof())
+	{
+		return false;
+	}
+
+	steps = std::move(loadedSteps);
+	return true;
+}
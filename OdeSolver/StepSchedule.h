@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+using std::map;
+using std::string;
+using std::vector;
+
+// One accepted step: the time it started at, the dt it took, and the table size it was built with
+struct ScheduledStep
+{
+	double time = 0.0;
+	double dt = 0.0;
+	size_t tableSize = 0;
+};
+
+// The accepted steps of each method over a run.
+// Record one from a run and replay it on later runs of a similar problem so they skip the rejected tables adaptivity needs to find it again.
+// A method recording only touches its own steps so the method threads fill it in without locking once startRecording made room for them.
+class StepSchedule
+{
+private:
+
+	//Steps of each method in the order they were taken
+	map<unsigned int, vector<ScheduledStep>> steps;
+
+public:
+
+	//Start with no steps
+	StepSchedule() = default;
+
+	//Default Delete operator
+	~StepSchedule() = default;
+
+	//Drop what the method recorded before and make room for its new steps (not thread safe, call before the method threads start)
+	inline void startRecording(const unsigned int methodId) { steps[methodId].clear(); };
+
+	//Add a step the method accepted
+	inline void record(const unsigned int methodId, const ScheduledStep& step) { steps.find(methodId)->second.push_back(step); };
+
+	//Find the step to replay at the time moving the cursor (start it at 0) past the steps already behind us. False once the schedule runs out.
+	const bool findStep(const unsigned int, const double, size_t&, ScheduledStep&) const;
+
+	//Get the steps a method recorded (empty if it has none)
+	const vector<ScheduledStep>& getSteps(const unsigned int) const;
+
+	//Check if nothing was recorded
+	const bool empty() const;
+
+	//Drop every step
+	inline void clear() { steps.clear(); };
+
+	//Save the schedule as text lines of method id, time, dt, and table size
+	bool save(const string&) const;
+
+	//Load a schedule saved with save, replacing this one
+	bool load(const string&);
+};
@@ -0,0 +1,68 @@
+#include "StepStream.h"
+
+/// <summary>
+/// Start the solver on its own thread streaming into our queue
+/// </summary>
+/// <param name="solver"></param>
+/// <param name="problem"></param>
+/// <param name="initalConditionsIn"></param>
+/// <param name="beginTime"></param>
+/// <param name="endTime"></param>
+/// <param name="capacity"></param>
+/// <param name="keepResults"></param>
+StepStream::StepStream(OdeSolver& solver, const OdeFunIF* problem, crvec initalConditionsIn, const double beginTime, const double endTime, const size_t capacity, const bool keepResults) :
+	queue(capacity),
+	initalConditions(initalConditionsIn),
+	current{ 0, StateVector(vec(), OdeSolverParams()) }
+{
+	producer = thread([this, &solver, problem, beginTime, endTime, keepResults]()
+		{
+			try
+			{
+				solver.runStreaming(problem, initalConditions, beginTime, endTime, queue, keepResults, token);
+			}
+			catch (...)
+			{
+				//End the stream with the error so the consumer sees it once the queue is drained
+				queue.close(std::current_exception());
+			}
+		});
+}
+
+/// <summary>
+/// Stop the run if the consumer left early and wait for the thread
+/// </summary>
+StepStream::~StepStream()
+{
+	//Cancel and close so the methods are not stuck waiting on a full queue
+	token.cancel();
+	queue.close();
+
+	if (producer.joinable())
+	{
+		producer.join();
+	}
+}
+
+/// <summary>
+/// Wait for the next step. If the run failed we pass its error on once the steps before it were read.
+/// </summary>
+/// <param name="nextStep"></param>
+/// <returns></returns>
+bool StepStream::next(StreamedStep& nextStep)
+{
+	//Get the next step
+	if (queue.pop(nextStep))
+	{
+		return true;
+	}
+
+	//The run is done, pass on any error it threw
+	const exception_ptr failure = queue.getFailure();
+	if (failure)
+	{
+		std::rethrow_exception(failure);
+	}
+
+	return false;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <iterator>
+#include <thread>
+
+#include "CancellationToken.h"
+#include "OdeSolver.h"
+#include "StepQueue.h"
+
+using std::thread;
+
+// Class that runs a solver on its own thread and hands out each accepted step as it is found.
+// Iterate over it like a range: the loop blocks until the next step is ready and ends once the run is done.
+// The queue between the run and the consumer is bounded so a slow consumer slows the run down instead of growing memory.
+// Destroying the stream early cancels the run.
+class StepStream
+{
+private:
+
+	//Bounded queue between the method threads and the consumer
+	StepQueue queue;
+
+	//Token to cancel the run if the consumer leaves early
+	CancellationToken token;
+
+	//Our copy of the inital condition (the run reads it the whole time)
+	vec initalConditions;
+
+	//The step the iterator is looking at
+	StreamedStep current;
+
+	//Thread running the solver
+	thread producer;
+
+public:
+
+	//Iterator over the streamed steps
+	class iterator
+	{
+	private:
+
+		//Stream we are reading (null at the end)
+		StepStream* stream;
+
+	public:
+
+		using iterator_category = std::input_iterator_tag;
+		using value_type = StreamedStep;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const StreamedStep*;
+		using reference = const StreamedStep&;
+
+		//Start reading the stream (null builds the end)
+		inline iterator(StepStream* streamIn) : stream(streamIn) { ++(*this); };
+
+		//Get the current step
+		inline reference operator*() const { return stream->current; };
+		inline pointer operator->() const { return &stream->current; };
+
+		//Wait for the next step
+		inline iterator& operator++() { if (stream != nullptr && !stream->next(stream->current)) { stream = nullptr; } return *this; };
+
+		//Only the end compares equal to a finished iterator
+		inline bool operator==(const iterator& other) const { return stream == other.stream; };
+		inline bool operator!=(const iterator& other) const { return stream != other.stream; };
+	};
+
+	//Start running the solver streaming at most capacity steps ahead of the consumer
+	StepStream(OdeSolver&, const OdeFunIF*, crvec, const double, const double, const size_t = 64, const bool = true);
+
+	//Can not copy or move the running thread
+	StepStream(const StepStream&) = delete;
+	StepStream& operator=(const StepStream&) = delete;
+
+	//Cancel the run if it is still going and wait for it
+	~StepStream();
+
+	//Wait for the next step. Returns false once the run is done and every step was read.
+	bool next(StreamedStep&);
+
+	//Iterate over the steps
+	inline iterator begin() { return iterator(this); };
+	inline iterator end() { return iterator(nullptr); };
+};
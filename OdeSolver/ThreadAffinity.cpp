@@ -0,0 +1,216 @@
+#include "ThreadAffinity.h"
+
+#include <algorithm>
+#include <thread>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+/// <summary>
+/// Pin the calling thread to the core its slot lands on. Slots past the number of cores wrap around.
+/// </summary>
+/// <param name="placement"></param>
+/// <param name="slot"></param>
+/// <returns></returns>
+bool ThreadAffinity::pinCurrentThread(const PLACEMENT placement, const size_t slot)
+{
+	//Nothing to do if we are not placing threads
+	if (placement == PLACEMENT::NONE)
+	{
+		return false;
+	}
+
+	//Get our core
+	const vector<unsigned int> cores = getCoreOrder(placement);
+	if (cores.empty())
+	{
+		return false;
+	}
+	const unsigned int core = cores[slot % cores.size()];
+
+#if defined(_WIN32)
+	//The mask only covers the first processor group
+	if (core >= sizeof(DWORD_PTR) * 8)
+	{
+		return false;
+	}
+	return SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << core) != 0;
+#elif defined(__linux__)
+	cpu_set_t coreSet;
+	CPU_ZERO(&coreSet);
+	CPU_SET(core, &coreSet);
+	return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &coreSet) == 0;
+#else
+	return false;
+#endif
+}
+
+/// <summary>
+/// Lay the cores out in the order threads are handed them
+/// </summary>
+/// <param name="placement"></param>
+/// <returns></returns>
+vector<unsigned int> ThreadAffinity::getCoreOrder(const PLACEMENT placement)
+{
+	const vector<vector<unsigned int>>& nodes = getNodes();
+	vector<unsigned int> cores;
+
+	//Fill each node in turn
+	if (placement == PLACEMENT::COMPACT)
+	{
+		for (const vector<unsigned int>& node : nodes)
+		{
+			cores.insert(cores.end(), node.begin(), node.end());
+		}
+	}
+	//Take the next core of each node in turn
+	else if (placement == PLACEMENT::SPREAD)
+	{
+		size_t largestNode = 0;
+		for (const vector<unsigned int>& node : nodes)
+		{
+			largestNode = std::max(largestNode, node.size());
+		}
+
+		for (size_t i = 0; i < largestNode; ++i)
+		{
+			for (const vector<unsigned int>& node : nodes)
+			{
+				if (i < node.size())
+				{
+					cores.push_back(node[i]);
+				}
+			}
+		}
+	}
+
+	return cores;
+}
+
+/// <summary>
+/// The topology does not change while we run so we only read it once
+/// </summary>
+/// <returns></returns>
+const vector<vector<unsigned int>>& ThreadAffinity::getNodes()
+{
+	static const vector<vector<unsigned int>> nodes = findNodes();
+	return nodes;
+}
+
+/// <summary>
+/// Ask the OS for the cores of each node. Without NUMA information every core goes in one node.
+/// </summary>
+/// <returns></returns>
+vector<vector<unsigned int>> ThreadAffinity::findNodes()
+{
+	vector<vector<unsigned int>> nodes;
+
+#if defined(_WIN32)
+	//Get the cores of each node in the first processor group
+	ULONG highestNode = 0;
+	if (GetNumaHighestNodeNumber(&highestNode))
+	{
+		for (ULONG node = 0; node <= highestNode; ++node)
+		{
+			ULONGLONG mask = 0;
+			if (!GetNumaNodeProcessorMask(static_cast<UCHAR>(node), &mask) || mask == 0)
+			{
+				continue;
+			}
+
+			vector<unsigned int> cores;
+			for (unsigned int core = 0; core < 64; ++core)
+			{
+				if (mask & (static_cast<ULONGLONG>(1) << core))
+				{
+					cores.push_back(core);
+				}
+			}
+			nodes.push_back(cores);
+		}
+	}
+#elif defined(__linux__)
+	//Only hand out cores we are allowed to run on
+	cpu_set_t allowed;
+	CPU_ZERO(&allowed);
+	const bool hasAllowed = sched_getaffinity(0, sizeof(cpu_set_t), &allowed) == 0;
+
+	//Read the core list of each node (lists look like 0-3,8-11)
+	for (unsigned int node = 0; ; ++node)
+	{
+		std::ifstream cpuList("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+		if (!cpuList)
+		{
+			break;
+		}
+
+		vector<unsigned int> cores;
+		std::string range;
+		while (std::getline(cpuList, range, ','))
+		{
+			unsigned int first = 0;
+			unsigned int last = 0;
+			char dash = 0;
+			std::istringstream rangeStream(range);
+			if (!(rangeStream >> first))
+			{
+				continue;
+			}
+			last = (rangeStream >> dash >> last) ? last : first;
+
+			for (unsigned int core = first; core <= last; ++core)
+			{
+				if (!hasAllowed || (core < CPU_SETSIZE && CPU_ISSET(core, &allowed)))
+				{
+					cores.push_back(core);
+				}
+			}
+		}
+
+		if (!cores.empty())
+		{
+			nodes.push_back(cores);
+		}
+	}
+
+	//Without the node files use every core we may run on
+	if (nodes.empty() && hasAllowed)
+	{
+		vector<unsigned int> cores;
+		for (unsigned int core = 0; core < CPU_SETSIZE; ++core)
+		{
+			if (CPU_ISSET(core, &allowed))
+			{
+				cores.push_back(core);
+			}
+		}
+		if (!cores.empty())
+		{
+			nodes.push_back(cores);
+		}
+	}
+#endif
+
+	//Fall back on one node of every core
+	if (nodes.empty())
+	{
+		vector<unsigned int> cores;
+		for (unsigned int core = 0; core < std::max(std::thread::hardware_concurrency(), 1u); ++core)
+		{
+			cores.push_back(core);
+		}
+		nodes.push_back(cores);
+	}
+
+	return nodes;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+using std::vector;
+
+// Helper to pin threads to cores so a thread stays next to the memory it first touched.
+// The cores are grouped by NUMA node. Compact placement fills one node before moving to the next
+// while spread placement deals the threads out across the nodes in turn.
+// Pinning is best effort: on a platform we do not support, or if the OS refuses, the thread is left where it is.
+class ThreadAffinity
+{
+public:
+
+	//Enumerations for how threads are placed on the cores
+	enum class PLACEMENT
+	{
+		NONE	= 0, //Let the OS move the threads around
+		COMPACT	= 1, //Fill the cores of one node before the next
+		SPREAD	= 2  //Round robin the threads across the nodes
+	};
+
+	//Pin the calling thread to the core for its slot under the placement. Returns true if it was pinned.
+	static bool pinCurrentThread(const PLACEMENT, const size_t);
+
+	//Get the cores the threads are handed out to in order under the placement
+	static vector<unsigned int> getCoreOrder(const PLACEMENT);
+
+	//Get the cores of each NUMA node we are allowed to run on
+	static const vector<vector<unsigned int>>& getNodes();
+
+private:
+
+	//Read the nodes and their cores from the OS
+	static vector<vector<unsigned int>> findNodes();
+};
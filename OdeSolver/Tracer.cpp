@@ -0,0 +1,241 @@
+#include "Tracer.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+
+thread_local Tracer::ThreadRing* Tracer::threadRing = nullptr;
+thread_local unsigned int Tracer::threadId = 0;
+thread_local unsigned int Tracer::threadMethod = 0;
+
+/// <summary>
+/// Turn tracing on. Rings already handed out keep their size, new ones get the capacity.
+/// </summary>
+/// <param name="capacityIn"></param>
+void Tracer::enable(const size_t capacityIn)
+{
+	capacity().store(std::max(capacityIn, static_cast<size_t>(1)), std::memory_order_relaxed);
+	enabled().store(true, std::memory_order_relaxed);
+}
+
+/// <summary>
+/// Turn tracing off
+/// </summary>
+void Tracer::disable()
+{
+	enabled().store(false, std::memory_order_relaxed);
+}
+
+/// <summary>
+/// Save the method the calling thread is on
+/// </summary>
+/// <param name="methodId"></param>
+void Tracer::setThreadMethod(const unsigned int methodId)
+{
+	threadMethod = methodId;
+}
+
+/// <summary>
+/// Get the method the calling thread is on
+/// </summary>
+/// <returns></returns>
+unsigned int Tracer::getThreadMethod()
+{
+	return threadMethod;
+}
+
+/// <summary>
+/// Write the span into the next slot of the calling threads ring (claiming a ring on the first span)
+/// </summary>
+/// <param name="type"></param>
+/// <param name="methodId"></param>
+/// <param name="detail"></param>
+/// <param name="begin"></param>
+/// <param name="end"></param>
+void Tracer::record(const SPAN_TYPES type, const unsigned int methodId, const int detail, const long long begin, const long long end)
+{
+	ThreadRing& ring = threadRing != nullptr ? *threadRing : claimRing();
+
+	TraceEvent& event = ring.events[ring.recorded % ring.events.size()];
+	event.begin = begin;
+	event.end = end;
+	event.threadId = threadId;
+	event.methodId = methodId;
+	event.detail = detail;
+	event.type = type;
+	++ring.recorded;
+}
+
+/// <summary>
+/// Reuse a ring a finished thread gave back, otherwise build a new one. Only a threads first span takes the lock.
+/// </summary>
+/// <returns></returns>
+Tracer::ThreadRing& Tracer::claimRing()
+{
+	static atomic<unsigned int> nextThreadId(1);
+
+	//Give the ring back when we exit
+	thread_local RingHandle handle;
+
+	std::lock_guard<mutex> lock(registryLock());
+	vector<unique_ptr<ThreadRing>>& allRings = rings();
+
+	//Find a free ring
+	vector<unique_ptr<ThreadRing>>::iterator freeRing = std::find_if(allRings.begin(), allRings.end(), [](const unique_ptr<ThreadRing>& ring) { return !ring->inUse; });
+	if (freeRing == allRings.end())
+	{
+		allRings.push_back(std::make_unique<ThreadRing>());
+		allRings.back()->events.resize(capacity().load(std::memory_order_relaxed));
+		freeRing = allRings.end() - 1;
+	}
+
+	(*freeRing)->inUse = true;
+	threadRing = freeRing->get();
+	threadId = nextThreadId.fetch_add(1, std::memory_order_relaxed);
+	return **freeRing;
+}
+
+/// <summary>
+/// Give the ring back for the next new thread, its spans stay until they are overwritten or written out
+/// </summary>
+Tracer::RingHandle::~RingHandle()
+{
+	if (threadRing != nullptr)
+	{
+		std::lock_guard<mutex> lock(registryLock());
+		threadRing->inUse = false;
+		threadRing = nullptr;
+	}
+}
+
+/// <summary>
+/// Write each ring oldest span first as complete ("X") events in microseconds from the earliest span
+/// </summary>
+/// <param name="fileName"></param>
+/// <returns></returns>
+bool Tracer::write(const string& fileName)
+{
+	std::ofstream file(fileName);
+	if (!file)
+	{
+		return false;
+	}
+
+	std::lock_guard<mutex> lock(registryLock());
+	const vector<unique_ptr<ThreadRing>>& allRings = rings();
+
+	//Get where the kept spans start in each ring and the earliest time to measure from
+	long long origin = std::numeric_limits<long long>::max();
+	for (const unique_ptr<ThreadRing>& ring : allRings)
+	{
+		const size_t kept = std::min(ring->recorded, ring->events.size());
+		for (size_t i = ring->recorded - kept; i < ring->recorded; ++i)
+		{
+			origin = std::min(origin, ring->events[i % ring->events.size()].begin);
+		}
+	}
+
+	file << "{\"traceEvents\":[";
+	file << std::fixed << std::setprecision(3);
+	bool first = true;
+	for (const unique_ptr<ThreadRing>& ring : allRings)
+	{
+		const size_t kept = std::min(ring->recorded, ring->events.size());
+		for (size_t i = ring->recorded - kept; i < ring->recorded; ++i)
+		{
+			const TraceEvent& event = ring->events[i % ring->events.size()];
+
+			file << (first ? "\n" : ",\n");
+			file << "{\"name\":\"" << spanName(event.type) << "\",\"cat\":\"solver\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.threadId
+				<< ",\"ts\":" << static_cast<double>(event.begin - origin) / 1000.0
+				<< ",\"dur\":" << static_cast<double>(event.end - event.begin) / 1000.0
+				<< ",\"args\":{\"method\":" << event.methodId;
+			if (event.detail >= 0)
+			{
+				file << ",\"" << detailName(event.type) << "\":" << event.detail;
+			}
+			file << "}}";
+			first = false;
+		}
+	}
+	file << "\n],\"displayTimeUnit\":\"ns\"}\n";
+
+	return static_cast<bool>(file);
+}
+
+/// <summary>
+/// Forget every span but keep the rings
+/// </summary>
+void Tracer::clear()
+{
+	std::lock_guard<mutex> lock(registryLock());
+	for (unique_ptr<ThreadRing>& ring : rings())
+	{
+		ring->recorded = 0;
+	}
+}
+
+atomic<bool>& Tracer::enabled()
+{
+	static atomic<bool> tracing(false);
+	return tracing;
+}
+
+atomic<size_t>& Tracer::capacity()
+{
+	static atomic<size_t> ringCapacity(65536);
+	return ringCapacity;
+}
+
+mutex& Tracer::registryLock()
+{
+	static mutex lock;
+	return lock;
+}
+
+vector<unique_ptr<Tracer::ThreadRing>>& Tracer::rings()
+{
+	static vector<unique_ptr<ThreadRing>> allRings;
+	return allRings;
+}
+
+const char* Tracer::spanName(const SPAN_TYPES type)
+{
+	switch (type)
+	{
+	case SPAN_TYPES::BUILD_SOLUTION:
+		return "buildSolution";
+	case SPAN_TYPES::RUN_METHOD_ROW:
+		return "runMethod row";
+	case SPAN_TYPES::RUN_BATCHED_ROWS:
+		return "runBatchedRows";
+	case SPAN_TYPES::RICHARDSON_ERROR:
+		return "Richardson::error";
+	case SPAN_TYPES::UPDATE_DT:
+		return "updateDt";
+	case SPAN_TYPES::JACOBIAN_BUILD:
+		return "getJacobian";
+	case SPAN_TYPES::LINEAR_SOLVE:
+		return "solveSystem";
+	default:
+		return "unknown";
+	}
+}
+
+const char* Tracer::detailName(const SPAN_TYPES type)
+{
+	switch (type)
+	{
+	case SPAN_TYPES::BUILD_SOLUTION:
+		return "pass";
+	case SPAN_TYPES::RUN_METHOD_ROW:
+		return "row";
+	case SPAN_TYPES::RUN_BATCHED_ROWS:
+		return "rows";
+	case SPAN_TYPES::UPDATE_DT:
+		return "retry";
+	default:
+		return "detail";
+	}
+}
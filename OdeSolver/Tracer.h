@@ -0,0 +1,156 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using std::atomic;
+using std::mutex;
+using std::string;
+using std::unique_ptr;
+using std::vector;
+
+// Optional tracer that records timed spans of the solver phases and writes them out in the Chrome trace event format
+// (open the file in chrome://tracing or Perfetto).
+// Each thread records into its own fixed size ring buffer through a thread local pointer, so a span costs two clock reads and a
+// store without any lock or allocation. Once a ring is full the oldest spans are overwritten. A thread that exits hands its ring
+// on to the next new thread so runs that start fresh threads do not keep growing memory.
+// Nothing is formatted until write, which should only be called once the traced threads are done (after the run returns).
+class Tracer
+{
+public:
+
+	//Enumerations for the phases we trace
+	enum class SPAN_TYPES
+	{
+		BUILD_SOLUTION		= 0, //One pass of buildSolution building and checking a table
+		RUN_METHOD_ROW		= 1, //One row of the richardson table
+		RUN_BATCHED_ROWS	= 2, //Every row of the table run together in batches
+		RICHARDSON_ERROR	= 3, //Extrapolating the table and measuring its error
+		UPDATE_DT			= 4, //Deciding the next dt and table size
+		JACOBIAN_BUILD		= 5, //Building the jacobian of an implict step
+		LINEAR_SOLVE		= 6, //Solving the newton system of an implict step
+		SPAN_COUNT
+	};
+
+	//Turn tracing on with the number of spans each thread keeps
+	static void enable(const size_t = 65536);
+
+	//Turn tracing off (what was recorded is kept until cleared)
+	static void disable();
+
+	//Check if we are tracing
+	inline static bool isEnabled() { return enabled().load(std::memory_order_relaxed); };
+
+	//Set the method the calling thread is working on so spans that do not know it get tagged with it
+	static void setThreadMethod(const unsigned int);
+
+	//Get the method the calling thread is working on
+	static unsigned int getThreadMethod();
+
+	//Get the time a span starts or ends at in nanoseconds
+	inline static long long now() { return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count(); };
+
+	//Record a span on the calling thread with its type, method, detail (row, pass, or decision, negative for none), begin, and end
+	static void record(const SPAN_TYPES, const unsigned int, const int, const long long, const long long);
+
+	//Write every recorded span to the file as Chrome trace JSON. Returns false if the file could not be written.
+	static bool write(const string&);
+
+	//Drop every recorded span
+	static void clear();
+
+private:
+
+	//One recorded span
+	struct TraceEvent
+	{
+		long long begin;
+		long long end;
+		unsigned int threadId;
+		unsigned int methodId;
+		int detail;
+		SPAN_TYPES type;
+	};
+
+	//Ring buffer one thread records into
+	struct ThreadRing
+	{
+		vector<TraceEvent> events;
+		size_t recorded = 0;
+		bool inUse = false;
+	};
+
+	//The calling threads ring, id, and method (plain thread locals so recording skips the thread local constructor check)
+	static thread_local ThreadRing* threadRing;
+	static thread_local unsigned int threadId;
+	static thread_local unsigned int threadMethod;
+
+	//Gives the calling threads ring back when the thread exits
+	struct RingHandle
+	{
+		~RingHandle();
+	};
+
+	//Shared state (function statics so they are built before the first use from any thread)
+	static atomic<bool>& enabled();
+	static atomic<size_t>& capacity();
+	static mutex& registryLock();
+	static vector<unique_ptr<ThreadRing>>& rings();
+
+	//Get a ring for the calling thread
+	static ThreadRing& claimRing();
+
+	//Get the name of a span type and the name of its detail
+	static const char* spanName(const SPAN_TYPES);
+	static const char* detailName(const SPAN_TYPES);
+};
+
+// Span that records itself from construction until end or destruction. Does nothing unless tracing is on when it is built.
+class TraceSpan
+{
+private:
+
+	//What we are timing
+	const Tracer::SPAN_TYPES type;
+
+	//Method and detail we are tagged with
+	const unsigned int methodId;
+	int detail;
+
+	//When we started (negative once recorded or if tracing is off)
+	long long begin;
+
+public:
+
+	//Start a span on the calling threads method
+	inline TraceSpan(const Tracer::SPAN_TYPES typeIn, const int detailIn = -1) :
+		type(typeIn),
+		methodId(Tracer::isEnabled() ? Tracer::getThreadMethod() : 0),
+		detail(detailIn),
+		begin(Tracer::isEnabled() ? Tracer::now() : -1) {};
+
+	//Can not copy a span
+	TraceSpan(const TraceSpan&) = delete;
+	TraceSpan& operator=(const TraceSpan&) = delete;
+
+	//Record the span if it is still open
+	inline ~TraceSpan() { end(); };
+
+	//Change the detail before the span ends
+	inline void setDetail(const int detailIn) { detail = detailIn; };
+
+	//Record the span now
+	inline void end()
+	{
+		if (begin >= 0)
+		{
+			Tracer::record(type, methodId, detail, begin, Tracer::now());
+			begin = -1;
+		}
+	};
+};
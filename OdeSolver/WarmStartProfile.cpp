@@ -0,0 +1,90 @@
+#include "WarmStartProfile.h"
+
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <utility>
+
+/// <summary>
+/// Get the entry the method saved closest to the time
+/// </summary>
+/// <param name="methodId"></param>
+/// <param name="time"></param>
+/// <param name="entry"></param>
+/// <returns></returns>
+const bool WarmStartProfile::find(const unsigned int methodId, const double time, WarmStartEntry& entry) const
+{
+	const map<unsigned int, vector<WarmStartEntry>>::const_iterator methodEntries = entries.find(methodId);
+	if (methodEntries == entries.cend() || methodEntries->second.empty())
+	{
+		return false;
+	}
+
+	entry = methodEntries->second.front();
+	for (const WarmStartEntry& currentEntry : methodEntries->second)
+	{
+		if (std::fabs(currentEntry.time - time) < std::fabs(entry.time - time))
+		{
+			entry = currentEntry;
+		}
+	}
+
+	return true;
+}
+
+/// <summary>
+/// Write a line per method at full precision
+/// </summary>
+/// <param name="fileName"></param>
+/// <returns></returns>
+bool WarmStartProfile::save(const string& fileName) const
+{
+	std::ofstream file(fileName);
+	if (!file)
+	{
+		return false;
+	}
+
+	file << std::setprecision(std::numeric_limits<double>::max_digits10);
+	for (const auto& methodEntries : entries)
+	{
+		for (const WarmStartEntry& entry : methodEntries.second)
+		{
+			file << methodEntries.first << " " << entry.time << " " << entry.dt << " " << entry.upgradeFactor << " " << entry.tableSize << "\n";
+		}
+	}
+
+	return static_cast<bool>(file);
+}
+
+/// <summary>
+/// Read the lines back in, keeping this profile as it was if the file can not be opened or a line is bad
+/// </summary>
+/// <param name="fileName"></param>
+/// <returns></returns>
+bool WarmStartProfile::load(const string& fileName)
+{
+	std::ifstream file(fileName);
+	if (!file)
+	{
+		return false;
+	}
+
+	map<unsigned int, vector<WarmStartEntry>> loadedEntries;
+	unsigned int methodId = 0;
+	WarmStartEntry entry;
+	while (file >> methodId >> entry.time >> entry.dt >> entry.upgradeFactor >> entry.tableSize)
+	{
+		loadedEntries[methodId].push_back(entry);
+	}
+
+	//Make sure we stopped at the end and not on a bad line
+	if (!file.eof())
+	{
+		return false;
+	}
+
+	entries = std::move(loadedEntries);
+	return true;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+using std::map;
+using std::string;
+using std::vector;
+
+// What a method learned about stepping from a time: the dt, the upgrade factor updateDt applies to it for the step, and the table size
+struct WarmStartEntry
+{
+	double time = 0.0;
+	double dt = 0.0;
+	double upgradeFactor = 0.0;
+	size_t tableSize = 0;
+};
+
+// The learned step size and table size of each method, carried from one run to the next with warm start or saved to a file.
+// A method keeps what it learned at the start of its run and at the end, so a run repeating the last one picks up its first step
+// and a run carrying on from where the last one ended picks up its last step.
+class WarmStartProfile
+{
+private:
+
+	//What each method learned
+	map<unsigned int, vector<WarmStartEntry>> entries;
+
+public:
+
+	//Start with nothing learned
+	WarmStartProfile() = default;
+
+	//Default Delete operator
+	~WarmStartProfile() = default;
+
+	//Save what the method learned, replacing what it had
+	inline void set(const unsigned int methodId, const vector<WarmStartEntry>& methodEntries) { entries[methodId] = methodEntries; };
+
+	//Get what the method learned closest to the time, false if nothing was saved for it
+	const bool find(const unsigned int, const double, WarmStartEntry&) const;
+
+	//Check if nothing was learned
+	inline const bool empty() const { return entries.empty(); };
+
+	//Drop everything
+	inline void clear() { entries.clear(); };
+
+	//Save the profile as text lines of method id, time, dt, upgrade factor, and table size
+	bool save(const string&) const;
+
+	//Load a profile saved with save, replacing this one
+	bool load(const string&);
+};
@@ -0,0 +1,205 @@
+#include "WorkStealingPool.h"
+
+/// <summary>
+/// Build a queue for each worker and start the threads (the caller is the last worker)
+/// </summary>
+/// <param name="workers"></param>
+/// <param name="placementIn"></param>
+WorkStealingPool::WorkStealingPool(const size_t workers, const ThreadAffinity::PLACEMENT placementIn) :
+	body(nullptr),
+	generation(0),
+	busyThreads(0),
+	hasFailed(false),
+	stopping(false),
+	placement(placementIn)
+{
+	//Get how many workers we want
+	const size_t workerCount = workers > 0 ? workers : std::max(static_cast<size_t>(thread::hardware_concurrency()), static_cast<size_t>(1));
+
+	//Build each workers queue
+	for (size_t worker = 0; worker < workerCount; ++worker)
+	{
+		queues.push_back(std::make_unique<WorkerQueue>());
+	}
+
+	//Start the threads
+	for (size_t worker = 0; worker + 1 < workerCount; ++worker)
+	{
+		threads.push_back(thread(&WorkStealingPool::threadLoop, this, worker));
+	}
+}
+
+/// <summary>
+/// Wake the threads to stop and join them
+/// </summary>
+WorkStealingPool::~WorkStealingPool()
+{
+	{
+		unique_lock<mutex> lock(poolLock);
+		stopping = true;
+	}
+
+	workReady.notify_all();
+
+	for (vector<thread>::iterator threadItr = threads.begin(); threadItr != threads.end(); ++threadItr)
+	{
+		threadItr->join();
+	}
+}
+
+/// <summary>
+/// Hand out the indices in contiguous blocks, work our own share, and wait for the threads to finish theirs
+/// </summary>
+/// <param name="count"></param>
+/// <param name="loopBody"></param>
+void WorkStealingPool::parallelFor(const size_t count, const function<void(const size_t, const size_t)>& loopBody)
+{
+	//Nothing to do
+	if (count == 0)
+	{
+		return;
+	}
+
+	//Split the indices up into a block per worker
+	const size_t workerCount = queues.size();
+	for (size_t worker = 0; worker < workerCount; ++worker)
+	{
+		unique_lock<mutex> queueLock(queues[worker]->queueLock);
+		for (size_t indx = worker * count / workerCount; indx < (worker + 1) * count / workerCount; ++indx)
+		{
+			queues[worker]->indices.push_back(indx);
+		}
+	}
+
+	//Start the threads on the loop
+	{
+		unique_lock<mutex> lock(poolLock);
+		body = &loopBody;
+		failure = nullptr;
+		hasFailed.store(false);
+		busyThreads = threads.size();
+		++generation;
+	}
+	workReady.notify_all();
+
+	//Work as the last worker
+	work(workerCount - 1);
+
+	//Wait for the threads so the body is not used after we return
+	exception_ptr loopFailure;
+	{
+		unique_lock<mutex> lock(poolLock);
+		workDone.wait(lock, [this]() { return busyThreads == 0; });
+		body = nullptr;
+		loopFailure = failure;
+	}
+
+	//Pass on the first error
+	if (loopFailure)
+	{
+		std::rethrow_exception(loopFailure);
+	}
+}
+
+/// <summary>
+/// Take from the back of our own queue, otherwise steal from the front of the next queue that has work
+/// </summary>
+/// <param name="worker"></param>
+/// <param name="indx"></param>
+/// <returns></returns>
+bool WorkStealingPool::nextIndex(const size_t worker, size_t& indx)
+{
+	//Check our own queue
+	{
+		WorkerQueue& ownQueue = *queues[worker];
+		unique_lock<mutex> queueLock(ownQueue.queueLock);
+		if (!ownQueue.indices.empty())
+		{
+			indx = ownQueue.indices.back();
+			ownQueue.indices.pop_back();
+			return true;
+		}
+	}
+
+	//Steal from the others starting with our neighbor
+	for (size_t offset = 1; offset < queues.size(); ++offset)
+	{
+		WorkerQueue& victim = *queues[(worker + offset) % queues.size()];
+		unique_lock<mutex> queueLock(victim.queueLock);
+		if (!victim.indices.empty())
+		{
+			indx = victim.indices.front();
+			victim.indices.pop_front();
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/// <summary>
+/// Run indices until every queue is empty. After an error the remaining indices are drained without running them.
+/// </summary>
+/// <param name="worker"></param>
+void WorkStealingPool::work(const size_t worker)
+{
+	size_t indx = 0;
+	while (nextIndex(worker, indx))
+	{
+		//Skip the work once something failed
+		if (hasFailed.load())
+		{
+			continue;
+		}
+
+		try
+		{
+			(*body)(indx, worker);
+		}
+		catch (...)
+		{
+			//Save the first error
+			unique_lock<mutex> lock(poolLock);
+			if (!failure)
+			{
+				failure = std::current_exception();
+			}
+			hasFailed.store(true);
+		}
+	}
+}
+
+/// <summary>
+/// Pin ourselves, then wait for a new loop, work it, and report back
+/// </summary>
+/// <param name="worker"></param>
+void WorkStealingPool::threadLoop(const size_t worker)
+{
+	//Stay on our core so what the loop body allocates stays on our node
+	ThreadAffinity::pinCurrentThread(placement, worker);
+
+	size_t seenGeneration = 0;
+	while (true)
+	{
+		//Wait for a new loop or to stop
+		{
+			unique_lock<mutex> lock(poolLock);
+			workReady.wait(lock, [this, seenGeneration]() { return stopping || generation != seenGeneration; });
+			if (stopping)
+			{
+				return;
+			}
+			seenGeneration = generation;
+		}
+
+		//Do our part
+		work(worker);
+
+		//Let the caller know we are done with the body
+		{
+			unique_lock<mutex> lock(poolLock);
+			--busyThreads;
+		}
+		workDone.notify_all();
+	}
+}
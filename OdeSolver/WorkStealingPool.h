@@ -0,0 +1,103 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ThreadAffinity.h"
+
+using std::atomic;
+using std::condition_variable;
+using std::deque;
+using std::exception_ptr;
+using std::function;
+using std::mutex;
+using std::thread;
+using std::unique_lock;
+using std::unique_ptr;
+using std::vector;
+
+// Pool of persistent worker threads that run an indexed loop with work stealing.
+// Each worker starts with a contiguous block of the indices in its own queue, works it from the back, and steals from the front of
+// the other queues once it runs dry, so uneven work does not leave threads idle. The calling thread works as the last worker.
+class WorkStealingPool
+{
+private:
+
+	//Queue of indices owned by one worker
+	struct WorkerQueue
+	{
+		mutex queueLock;
+		deque<size_t> indices;
+	};
+
+	//Our threads (one less than the workers since the caller works too)
+	vector<thread> threads;
+
+	//Each workers queue
+	vector<unique_ptr<WorkerQueue>> queues;
+
+	//Guards starting and finishing a loop
+	mutex poolLock;
+
+	//Signaled when a loop starts or the pool stops
+	condition_variable workReady;
+
+	//Signaled when a thread finishes its part of a loop
+	condition_variable workDone;
+
+	//The body of the current loop
+	const function<void(const size_t, const size_t)>* body;
+
+	//Bumped every loop so the threads know there is new work
+	size_t generation;
+
+	//Threads still working on the current loop
+	size_t busyThreads;
+
+	//First error thrown by the body
+	exception_ptr failure;
+
+	//Flag once the body threw so the rest of the indices are skipped
+	atomic<bool> hasFailed;
+
+	//Flag to shut the threads down
+	bool stopping;
+
+	//How our threads pin themselves (the caller is left alone)
+	const ThreadAffinity::PLACEMENT placement;
+
+	//Get the next index for a worker from its own queue or by stealing
+	bool nextIndex(const size_t, size_t&);
+
+	//Run indices until the loop is done
+	void work(const size_t);
+
+	//Thread main loop waiting for work
+	void threadLoop(const size_t);
+
+public:
+
+	//Start the pool with the number of workers (zero uses the hardware concurrency) and how its threads are pinned
+	WorkStealingPool(const size_t = 0, const ThreadAffinity::PLACEMENT = ThreadAffinity::PLACEMENT::NONE);
+
+	//Can not copy or move the running threads
+	WorkStealingPool(const WorkStealingPool&) = delete;
+	WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+	//Stop and join the threads
+	~WorkStealingPool();
+
+	//Get the number of workers (including the caller)
+	inline size_t getWorkerCount() const { return queues.size(); };
+
+	//Run body(index, worker) for every index below the count and wait for all of them. Rethrows the first error.
+	void parallelFor(const size_t, const function<void(const size_t, const size_t)>&);
+};
@@ -18,15 +18,15 @@ class Test : public OdeFunIF
 {
 public:
 
-	virtual std::valarray<double>& operator()(std::valarray<double>&,
-							const std::valarray<double>&,
+	virtual rvec operator()(rvec,
+							crvec,
 							const double&) const override;
 	
 };
 
 //Define our updating method
-std::valarray<double>& Test::operator()(std::valarray<double>& state,
-					  const std::valarray<double>& currentState,
+rvec Test::operator()(rvec state,
+					  crvec currentState,
 					  const double& currentTime) const
 {
 	/*
@@ -55,8 +55,8 @@ int main()
 	OdeFunIF* testProblem = new Test;
 
 	//Initalize our inital condion
-	std::valarray<double> ic = {1};//{ 0,0,0,0,0,10000};
-	std::valarray<double> sol(1);
+	vec ic = {1};//{ 0,0,0,0,0,10000};
+	vec sol(1);
 	double initalTime = 0.;
 
 	/*
@@ -91,6 +91,10 @@ int main()
 	OdeSolver solv2 = std::move(params);
 
 	solver.refreshParams(params);
+
+	//Print the progress every couple of seconds
+	ConsoleStepObserver console;
+	solver.setStepObserver(&console);
 		
 	solver.run(testProblem, ic, begin, end);
 
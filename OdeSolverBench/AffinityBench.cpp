@@ -0,0 +1,123 @@
+#include "Benchmarks.h"
+#include "OdeFunIF.h"
+#include "OdeSolver.h"
+#include "OdeSolverParams.h"
+#include "ThreadAffinity.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+
+using std::cout;
+
+//Method of lines heat equation on a ring so the state is as large as we like
+class HeatRing : public OdeFunIF
+{
+private:
+
+	//Diffusion over the grid spacing squared
+	const double diffusion;
+
+public:
+
+	HeatRing(const double diffusionIn) : diffusion(diffusionIn) {};
+
+	virtual rvec operator()(rvec,
+							crvec,
+							const double&) const override;
+};
+
+//Second difference with the neighbors on each side
+rvec HeatRing::operator()(rvec state, crvec currentState, const double&) const
+{
+	const size_t size = currentState.size();
+	for (size_t i = 0; i < size; ++i)
+	{
+		state[i] = diffusion * (currentState[(i + size - 1) % size] - 2.0 * currentState[i] + currentState[(i + 1) % size]);
+	}
+
+	return state;
+}
+
+//Get the name of a placement to print
+const char* placementName(const ThreadAffinity::PLACEMENT placement)
+{
+	switch (placement)
+	{
+	case ThreadAffinity::PLACEMENT::COMPACT:
+		return "compact";
+	case ThreadAffinity::PLACEMENT::SPREAD:
+		return "spread";
+	default:
+		return "none";
+	}
+}
+
+//Time every method solving a large state under each thread placement.
+//Usage: OdeSolverBench affinity [components] [end time] [repeats]
+int runAffinityBench(int argc, char* argv[])
+{
+	//Size of the problem
+	const size_t components = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+	const double endTime = argc > 2 ? std::strtod(argv[2], nullptr) : .5;
+	const size_t repeats = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 3;
+
+	//Print the topology we found
+	const vector<vector<unsigned int>>& nodes = ThreadAffinity::getNodes();
+	cout << "NUMA nodes: " << nodes.size() << "\n";
+	for (size_t node = 0; node < nodes.size(); ++node)
+	{
+		cout << "\tnode " << node << ": " << nodes[node].size() << " cores\n";
+	}
+
+	//A smooth bump on the ring
+	HeatRing problem(1.0);
+	vec ic(components);
+	for (size_t i = 0; i < components; ++i)
+	{
+		ic[i] = 1.0 + std::sin(2.0 * 3.14159265358979323846 * static_cast<double>(i) / static_cast<double>(components));
+	}
+
+	//Run every explicit method so each one has its own thread and tables
+	OdeSolverParams params;
+	params.upperError = 1e-6;
+	params.lowerError = 1e-9;
+	params.redutionFactor = 2.;
+	params.dt = .01;
+	params.minDt = .1;
+	params.maxDt = 2.;
+	params.minTableSize = 3;
+	params.maxTableSize = 6;
+	params.useEuler = true;
+	params.useRK2 = true;
+	params.useRK4 = true;
+
+	cout << "Components: " << components << "; End Time: " << endTime << "; Repeats: " << repeats << "\n";
+
+	//Time each placement taking the best of the repeats
+	for (const ThreadAffinity::PLACEMENT placement : { ThreadAffinity::PLACEMENT::NONE, ThreadAffinity::PLACEMENT::COMPACT, ThreadAffinity::PLACEMENT::SPREAD })
+	{
+		params.threadPlacement = placement;
+		double bestTime = std::numeric_limits<double>::infinity();
+
+		for (size_t repeat = 0; repeat < repeats; ++repeat)
+		{
+			OdeSolver solver(params);
+
+			std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+			solver.run(&problem, ic, 0.0, endTime);
+			std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
+
+			bestTime = std::min(bestTime, std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1).count());
+		}
+
+		cout << std::setw(8) << placementName(placement) << ": " << std::setprecision(4) << bestTime << " s\n";
+	}
+
+	return 0;
+}
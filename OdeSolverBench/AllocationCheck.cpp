@@ -0,0 +1,121 @@
+#include "Benchmarks.h"
+#include "BenchProblems.h"
+#include "MemoryTracker.h"
+#include "OdeSolver.h"
+#include "OdeSolverParams.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+using std::cerr;
+using std::cout;
+
+namespace
+{
+	//One method stepping one problem
+	struct AllocationScenario
+	{
+		const char* name;
+		const BenchProblem* problem;
+		SolverIF::SOLVER_TYPES method;
+	};
+
+	//Configuration the scenarios step with, only running the method asked for
+	OdeSolverParams buildAllocationParams(const SolverIF::SOLVER_TYPES method, const bool realTime)
+	{
+		OdeSolverParams params;
+		params.upperError = 1e-6;
+		params.lowerError = 1e-9;
+		params.redutionFactor = 2.;
+		params.dt = .01;
+		params.minDt = .1;
+		params.maxDt = 2.;
+		params.minTableSize = 3;
+		params.maxTableSize = 6;
+		params.useEuler = method == SolverIF::SOLVER_TYPES::EULER;
+		params.useRK2 = method == SolverIF::SOLVER_TYPES::RUNGE_KUTTA_TWO;
+		params.useRK4 = method == SolverIF::SOLVER_TYPES::RUNGE_KUTTA_FOUR;
+
+		//Give real time mode room to retry like adaptive control would so both take the same steps
+		params.realTime = realTime;
+		params.realTimeMaxRetries = 8;
+		params.realTimeBudget = 1.0;
+		return params;
+	}
+}
+
+//Step each scenario past its first steps and count what the steps after that allocate. The tables, stage scratch, and linear algebra
+//must never allocate once stepping has started. Appending a result copies the state, so results may only allocate outside real time mode.
+//Usage: OdeSolverBench alloc [steps]
+int runAllocationCheck(int argc, char* argv[])
+{
+	const size_t steps = std::max(argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200ul, 1ul);
+	const size_t warmupSteps = 10;
+
+	//Nothing is counted without the counting layer
+	if (!MemoryTracker::isAvailable())
+	{
+		cerr << "Build with ODESOLVER_COUNT_ALLOCATIONS to check allocations\n";
+		return 1;
+	}
+
+	//Problems the scenarios step
+	const LorenzProblem lorenz;
+	const BrusselatorProblem brusselator(32);
+
+	const vector<AllocationScenario> scenarios = {
+		{ "Lorenz Euler", &lorenz, SolverIF::SOLVER_TYPES::EULER },
+		{ "Lorenz RK2", &lorenz, SolverIF::SOLVER_TYPES::RUNGE_KUTTA_TWO },
+		{ "Lorenz RK4", &lorenz, SolverIF::SOLVER_TYPES::RUNGE_KUTTA_FOUR },
+		{ "Brusselator RK4", &brusselator, SolverIF::SOLVER_TYPES::RUNGE_KUTTA_FOUR } };
+
+	MemoryTracker::enable();
+
+	bool allocated = false;
+	for (const AllocationScenario& scenario : scenarios)
+	{
+		for (const bool realTime : { false, true })
+		{
+			const unsigned int methodId = static_cast<unsigned int>(scenario.method);
+			const double endTime = scenario.problem->getEndTime();
+
+			//Get past the first steps, which size everything
+			OdeSolver solver(buildAllocationParams(scenario.method, realTime));
+			solver.startStepping(scenario.problem, scenario.problem->getInitalCondition(), 0.0, endTime);
+			for (size_t step = 0; step < warmupSteps && solver.getCurrentTime() < endTime; ++step)
+			{
+				solver.step();
+			}
+
+			//Count the steady state steps
+			MemoryTracker::restart(methodId);
+			const size_t acceptedStart = solver.getStats(methodId).acceptedSteps;
+			for (size_t step = 0; step < steps && solver.getCurrentTime() < endTime; ++step)
+			{
+				solver.step();
+			}
+			const size_t accepted = solver.getStats(methodId).acceptedSteps - acceptedStart;
+
+			//Check every category a step may not allocate in
+			cout << std::setw(16) << scenario.name << (realTime ? " real time" : " adaptive ") << ": " << std::setw(5) << accepted << " steps";
+			bool scenarioAllocated = accepted == 0;
+			for (size_t category = 0; category < static_cast<size_t>(MemoryTracker::CATEGORIES::CATEGORY_COUNT); ++category)
+			{
+				const MemoryTracker::CATEGORIES current = static_cast<MemoryTracker::CATEGORIES>(category);
+				const size_t allocations = MemoryTracker::getUsage(methodId, current).allocations;
+				scenarioAllocated |= allocations > 0 && (realTime || current != MemoryTracker::CATEGORIES::RESULTS);
+				cout << ", " << MemoryTracker::categoryName(current) << " " << allocations;
+			}
+			cout << (accepted == 0 ? " [NO STEPS TAKEN]" : scenarioAllocated ? " [ALLOCATED]" : "") << "\n";
+
+			allocated |= scenarioAllocated;
+		}
+	}
+
+	MemoryTracker::disable();
+
+	cout << (allocated ? "Steady state steps allocated" : "No steady state allocations") << "\n";
+	return allocated ? 2 : 0;
+}
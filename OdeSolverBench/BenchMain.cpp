@@ -0,0 +1,35 @@
+#include "Benchmarks.h"
+
+#include <cstring>
+#include <iostream>
+
+using std::cerr;
+
+//Pick the benchmark to run by its name.
+//Usage: OdeSolverBench <affinity|suite|regress|alloc> [benchmark arguments]
+int main(int argc, char* argv[])
+{
+	if (argc > 1 && std::strcmp(argv[1], "affinity") == 0)
+	{
+		return runAffinityBench(argc - 1, argv + 1);
+	}
+	if (argc > 1 && std::strcmp(argv[1], "suite") == 0)
+	{
+		return runWorkPrecision(argc - 1, argv + 1);
+	}
+	if (argc > 1 && std::strcmp(argv[1], "regress") == 0)
+	{
+		return runRegressionBench(argc - 1, argv + 1);
+	}
+	if (argc > 1 && std::strcmp(argv[1], "alloc") == 0)
+	{
+		return runAllocationCheck(argc - 1, argv + 1);
+	}
+
+	cerr << "Usage: OdeSolverBench <affinity|suite|regress|alloc> [arguments]\n"
+		<< "\taffinity [components] [end time] [repeats]\n"
+		<< "\tsuite [csv file] [wall time per run] [problem name]\n"
+		<< "\tregress [baseline json] [threshold percent] [repeats] [--update] [--throughput]\n"
+		<< "\talloc [steps] (needs ODESOLVER_COUNT_ALLOCATIONS)\n";
+	return 1;
+}
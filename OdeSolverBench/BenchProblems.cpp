@@ -0,0 +1,257 @@
+#include "BenchProblems.h"
+
+#include <algorithm>
+
+namespace
+{
+	const double pi = 3.14159265358979323846;
+}
+
+BenchProblem::BenchProblem(const double referenceStepIn) :
+	referenceStep(referenceStepIn)
+{
+	//Nothing else to do here
+}
+
+/// <summary>
+/// One classic RK4 step of y at t with the scratch stages
+/// </summary>
+void BenchProblem::referenceStepRK4(rvec y, const double t, const double h, vec& k1, vec& k2, vec& k3, vec& k4, vec& stage) const
+{
+	const scalar half = static_cast<scalar>(.5 * h);
+	const scalar full = static_cast<scalar>(h);
+	const scalar two = static_cast<scalar>(2.0);
+
+	operator()(k1, y, t);
+	stage = y + half * k1;
+	operator()(k2, stage, t + .5 * h);
+	stage = y + half * k2;
+	operator()(k3, stage, t + .5 * h);
+	stage = y + full * k3;
+	operator()(k4, stage, t + h);
+	y += (full / static_cast<scalar>(6.0)) * (k1 + two * k2 + two * k3 + k4);
+}
+
+/// <summary>
+/// Step from the inital condition to the end time with a fixed step (the last step is shortened to land on the end)
+/// </summary>
+/// <param name="h"></param>
+/// <returns></returns>
+vec BenchProblem::fixedStepReference(const double h) const
+{
+	vec y = getInitalCondition();
+	vec k1(y.size()), k2(y.size()), k3(y.size()), k4(y.size()), stage(y.size());
+
+	const double endTime = getEndTime();
+	const size_t steps = static_cast<size_t>(std::ceil(endTime / h - 1e-9));
+	for (size_t i = 0; i < steps; ++i)
+	{
+		const double t = static_cast<double>(i) * h;
+		referenceStepRK4(y, t, std::min(h, endTime - t), k1, k2, k3, k4, stage);
+	}
+
+	return y;
+}
+
+/// <summary>
+/// Use the exact solution if we have one, otherwise extrapolate the fixed step runs at h and h / 2 (RK4 is fourth order)
+/// </summary>
+/// <param name="estimatedError"></param>
+/// <returns></returns>
+vec BenchProblem::getReference(double& estimatedError) const
+{
+	vec reference;
+	if (getExactSolution(reference))
+	{
+		estimatedError = 0.0;
+		return reference;
+	}
+
+	const vec coarse = fixedStepReference(referenceStep);
+	const vec fine = fixedStepReference(.5 * referenceStep);
+	reference = fine + (fine - coarse) / static_cast<scalar>(15.0);
+	estimatedError = scaledError(fine, reference);
+
+	return reference;
+}
+
+/// <summary>
+/// Largest difference scaled by the size of the reference (absolute near zero and relative for large components)
+/// </summary>
+/// <param name="state"></param>
+/// <param name="reference"></param>
+/// <returns></returns>
+double BenchProblem::scaledError(crvec state, crvec reference)
+{
+	double error = 0.0;
+	for (size_t i = 0; i < reference.size(); ++i)
+	{
+		error = std::max(error, static_cast<double>(std::abs(state[i] - reference[i]) / (1.0 + std::abs(reference[i]))));
+	}
+
+	return error;
+}
+
+rvec LorenzProblem::operator()(rvec state, crvec y, const double&) const
+{
+	state[0] = 10.0 * (y[1] - y[0]);
+	state[1] = y[0] * (28.0 - y[2]) - y[1];
+	state[2] = y[0] * y[1] - (8.0 / 3.0) * y[2];
+	return state;
+}
+
+rvec VanDerPolProblem::operator()(rvec state, crvec y, const double&) const
+{
+	state[0] = y[1];
+	state[1] = mu * (1.0 - y[0] * y[0]) * y[1] - y[0];
+	return state;
+}
+
+rvec RobertsonProblem::operator()(rvec state, crvec y, const double&) const
+{
+	state[0] = -.04 * y[0] + 1e4 * y[1] * y[2];
+	state[2] = 3e7 * y[1] * y[1];
+	state[1] = -state[0] - state[2];
+	return state;
+}
+
+/// <summary>
+/// u then v on the interior points with u = 1 and v = 3 held on the boundaries (A = 1, B = 3, alpha = 1 / 50)
+/// </summary>
+rvec BrusselatorProblem::operator()(rvec state, crvec y, const double&) const
+{
+	const double alpha = 1.0 / 50.0;
+	const double scale = alpha * static_cast<double>((points + 1) * (points + 1));
+
+	for (size_t i = 0; i < points; ++i)
+	{
+		const double u = y[i];
+		const double v = y[points + i];
+		const double uLeft = i == 0 ? 1.0 : y[i - 1];
+		const double uRight = i + 1 == points ? 1.0 : y[i + 1];
+		const double vLeft = i == 0 ? 3.0 : y[points + i - 1];
+		const double vRight = i + 1 == points ? 3.0 : y[points + i + 1];
+
+		state[i] = 1.0 + u * u * v - 4.0 * u + scale * (uLeft - 2.0 * u + uRight);
+		state[points + i] = 3.0 * u - u * u * v + scale * (vLeft - 2.0 * v + vRight);
+	}
+
+	return state;
+}
+
+vec BrusselatorProblem::getInitalCondition() const
+{
+	vec y(2 * points);
+	for (size_t i = 0; i < points; ++i)
+	{
+		const double x = static_cast<double>(i + 1) / static_cast<double>(points + 1);
+		y[i] = 1.0 + std::sin(2.0 * pi * x);
+		y[points + i] = 3.0;
+	}
+
+	return y;
+}
+
+/// <summary>
+/// Positions x then y of the seven bodies followed by their velocities, the masses are 1 through 7
+/// </summary>
+rvec PleiadesProblem::operator()(rvec state, crvec y, const double&) const
+{
+	const size_t bodies = 7;
+	for (size_t i = 0; i < bodies; ++i)
+	{
+		state[i] = y[2 * bodies + i];
+		state[bodies + i] = y[3 * bodies + i];
+
+		double ax = 0.0;
+		double ay = 0.0;
+		for (size_t j = 0; j < bodies; ++j)
+		{
+			if (j == i)
+			{
+				continue;
+			}
+
+			const double dx = y[j] - y[i];
+			const double dy = y[bodies + j] - y[bodies + i];
+			const double r2 = dx * dx + dy * dy;
+			const double weight = static_cast<double>(j + 1) / (r2 * std::sqrt(r2));
+			ax += weight * dx;
+			ay += weight * dy;
+		}
+
+		state[2 * bodies + i] = ax;
+		state[3 * bodies + i] = ay;
+	}
+
+	return state;
+}
+
+vec PleiadesProblem::getInitalCondition() const
+{
+	return vec{
+		3.0, 3.0, -1.0, -3.0, 2.0, -2.0, 2.0,
+		3.0, -3.0, 2.0, 0.0, 0.0, -4.0, 4.0,
+		0.0, 0.0, 0.0, 0.0, 0.0, 1.75, -1.5,
+		0.0, 0.0, 0.0, -1.25, 1.0, 0.0, 0.0 };
+}
+
+/// <summary>
+/// Pick the diffusion so the slowest mode decays at rate one
+/// </summary>
+/// <param name="pointsIn"></param>
+LinearDiffusionProblem::LinearDiffusionProblem(const size_t pointsIn) :
+	BenchProblem(1e-4),
+	points(pointsIn),
+	diffusion(1.0 / (4.0 * std::sin(pi / static_cast<double>(pointsIn)) * std::sin(pi / static_cast<double>(pointsIn))))
+{
+	//Nothing else to do here
+}
+
+rvec LinearDiffusionProblem::operator()(rvec state, crvec y, const double&) const
+{
+	for (size_t i = 0; i < points; ++i)
+	{
+		state[i] = diffusion * (y[(i + points - 1) % points] - 2.0 * y[i] + y[(i + 1) % points]);
+	}
+
+	return state;
+}
+
+vec LinearDiffusionProblem::getInitalCondition() const
+{
+	vec y(points);
+	for (size_t i = 0; i < points; ++i)
+	{
+		y[i] = 1.0 + std::sin(2.0 * pi * static_cast<double>(i) / static_cast<double>(points));
+	}
+
+	return y;
+}
+
+/// <summary>
+/// The inital condition is the constant plus the slowest mode which decays as exp(-t)
+/// </summary>
+/// <param name="exact"></param>
+/// <returns></returns>
+bool LinearDiffusionProblem::getExactSolution(vec& exact) const
+{
+	exact = getInitalCondition();
+	exact -= static_cast<scalar>(1.0);
+	exact *= static_cast<scalar>(std::exp(-getEndTime()));
+	exact += static_cast<scalar>(1.0);
+	return true;
+}
+
+vector<unique_ptr<BenchProblem>> buildBenchProblems()
+{
+	vector<unique_ptr<BenchProblem>> problems;
+	problems.emplace_back(new LorenzProblem());
+	problems.emplace_back(new VanDerPolProblem(1.0));
+	problems.emplace_back(new VanDerPolProblem(1000.0));
+	problems.emplace_back(new RobertsonProblem());
+	problems.emplace_back(new BrusselatorProblem(32));
+	problems.emplace_back(new PleiadesProblem());
+	problems.emplace_back(new LinearDiffusionProblem(500));
+	return problems;
+}
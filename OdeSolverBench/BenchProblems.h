@@ -0,0 +1,141 @@
+#pragma once
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "OdeFunIF.h"
+
+using std::string;
+using std::unique_ptr;
+using std::vector;
+
+// One problem of the benchmark suite: its right hand side, inital condition, horizon, and a reference solution at the end time.
+// Problems without a closed form solution get their reference from a fine fixed step RK4 run at two step sizes,
+// extrapolated together, so the reference does not depend on the solver we are measuring.
+class BenchProblem : public OdeFunIF
+{
+private:
+
+	//Step size the fixed step reference is run with
+	const double referenceStep;
+
+	//Take one classic RK4 step for the reference
+	void referenceStepRK4(rvec, const double, const double, vec&, vec&, vec&, vec&, vec&) const;
+
+	//Run the fixed step reference to the end time with the step
+	vec fixedStepReference(const double) const;
+
+protected:
+
+	//The exact solution at the end time if the problem has one
+	inline virtual bool getExactSolution(vec&) const { return false; };
+
+public:
+
+	//Build with the step the reference is computed with
+	BenchProblem(const double);
+
+	//Default Delete operator
+	virtual ~BenchProblem() = default;
+
+	//Get the name of the problem
+	virtual string getName() const = 0;
+
+	//Get the inital condition
+	virtual vec getInitalCondition() const = 0;
+
+	//Get the end time
+	virtual double getEndTime() const = 0;
+
+	//Flag for problems too stiff for the explict methods to finish in a reasonable time
+	inline virtual bool isStiff() const { return false; };
+
+	//Get the reference solution at the end time and an estimate of its own error
+	vec getReference(double&) const;
+
+	//Measure the error of a state against the reference (max over the components of the difference over 1 + |reference|)
+	static double scaledError(crvec, crvec);
+};
+
+// Lorenz attractor over a short horizon so the reference is still meaningful
+class LorenzProblem : public BenchProblem
+{
+public:
+	LorenzProblem() : BenchProblem(1e-4) {};
+	virtual rvec operator()(rvec, crvec, const double&) const override;
+	inline virtual string getName() const override { return "Lorenz"; };
+	inline virtual vec getInitalCondition() const override { return vec{ 1.0, 1.0, 1.0 }; };
+	inline virtual double getEndTime() const override { return 1.0; };
+};
+
+// Van der Pol oscillator, non stiff for a small mu and stiff for a large one
+class VanDerPolProblem : public BenchProblem
+{
+private:
+	const double mu;
+public:
+	VanDerPolProblem(const double muIn) : BenchProblem(muIn > 10.0 ? 1e-5 : 1e-3), mu(muIn) {};
+	virtual rvec operator()(rvec, crvec, const double&) const override;
+	inline virtual string getName() const override { return mu > 10.0 ? "VanDerPolStiff" : "VanDerPol"; };
+	inline virtual vec getInitalCondition() const override { return vec{ 2.0, 0.0 }; };
+	inline virtual double getEndTime() const override { return mu > 10.0 ? 1.0 : 10.0; };
+	inline virtual bool isStiff() const override { return mu > 10.0; };
+};
+
+// Robertson chemical kinetics
+class RobertsonProblem : public BenchProblem
+{
+public:
+	RobertsonProblem() : BenchProblem(1e-4) {};
+	virtual rvec operator()(rvec, crvec, const double&) const override;
+	inline virtual string getName() const override { return "Robertson"; };
+	inline virtual vec getInitalCondition() const override { return vec{ 1.0, 0.0, 0.0 }; };
+	inline virtual double getEndTime() const override { return 40.0; };
+	inline virtual bool isStiff() const override { return true; };
+};
+
+// One dimensional Brusselator reaction diffusion by the method of lines (u and v on the interior points)
+class BrusselatorProblem : public BenchProblem
+{
+private:
+	const size_t points;
+public:
+	BrusselatorProblem(const size_t pointsIn) : BenchProblem(1e-3), points(pointsIn) {};
+	virtual rvec operator()(rvec, crvec, const double&) const override;
+	inline virtual string getName() const override { return "BrusselatorMOL"; };
+	virtual vec getInitalCondition() const override;
+	inline virtual double getEndTime() const override { return 10.0; };
+};
+
+// Seven body planar gravity problem (positions then velocities)
+class PleiadesProblem : public BenchProblem
+{
+public:
+	PleiadesProblem() : BenchProblem(1e-5) {};
+	virtual rvec operator()(rvec, crvec, const double&) const override;
+	inline virtual string getName() const override { return "Pleiades"; };
+	virtual vec getInitalCondition() const override;
+	inline virtual double getEndTime() const override { return 3.0; };
+};
+
+// Large linear diffusion on a ring started on its slowest mode so the exact solution is known
+class LinearDiffusionProblem : public BenchProblem
+{
+private:
+	const size_t points;
+	const double diffusion;
+protected:
+	virtual bool getExactSolution(vec&) const override;
+public:
+	LinearDiffusionProblem(const size_t);
+	virtual rvec operator()(rvec, crvec, const double&) const override;
+	inline virtual string getName() const override { return "LinearDiffusion"; };
+	virtual vec getInitalCondition() const override;
+	inline virtual double getEndTime() const override { return 1.0; };
+	inline virtual bool isStiff() const override { return true; };
+};
+
+//Build every problem of the suite
+vector<unique_ptr<BenchProblem>> buildBenchProblems();
@@ -0,0 +1,15 @@
+#pragma once
+
+// Entry points of the benchmarks the bench executable can run, each takes the arguments after its name
+
+//Time a large problem under each thread placement
+int runAffinityBench(int, char*[]);
+
+//Measure the work against the error reached for every method and tolerance on the reference problems
+int runWorkPrecision(int, char*[]);
+
+//Time the fixed scenarios against the stored baseline and fail on a regression
+int runRegressionBench(int, char*[]);
+
+//Step the fixed scenarios with allocation counting and fail if a steady state step allocates
+int runAllocationCheck(int, char*[]);
@@ -0,0 +1,416 @@
+#include "Benchmarks.h"
+#include "BenchProblems.h"
+#include "CountingOdeFun.h"
+#include "OdeSolver.h"
+#include "OdeSolverParams.h"
+#include "Richardson.h"
+#include "RK4.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <thread>
+
+using std::cerr;
+using std::cout;
+using std::function;
+using std::map;
+
+namespace
+{
+	//What one scenario measured over its repeats
+	struct ScenarioResult
+	{
+		string name;
+
+		//Median operations per second and the median absolute deviation of the repeats
+		double throughput = 0.0;
+		double deviation = 0.0;
+
+		//Right hand side evaluations per operation
+		double rhsCalls = 0.0;
+
+		//Flag for a scenario whose own check of what it computed failed (a non finite checksum)
+		bool isValid = true;
+	};
+
+	//What the baseline holds for a scenario
+	struct BaselineEntry
+	{
+		double throughput = 0.0;
+		double rhsCalls = 0.0;
+	};
+
+	//One scenario: runs the number of operations asked for and returns the right hand side evaluations they took, clearing the flag if
+	//what it computed fails its check
+	struct Scenario
+	{
+		const char* name;
+		size_t operations;
+		function<size_t(const size_t, bool&)> body;
+	};
+
+	//Get the median of the samples
+	double median(vector<double> samples)
+	{
+		std::sort(samples.begin(), samples.end());
+		const size_t middle = samples.size() / 2;
+		return samples.size() % 2 == 1 ? samples[middle] : .5 * (samples[middle - 1] + samples[middle]);
+	}
+
+	//Run a scenario once to warm up and then once per repeat, keeping the median throughput and its deviation
+	ScenarioResult measureScenario(const Scenario& scenario, const size_t repeats)
+	{
+		bool isValid = true;
+		scenario.body(scenario.operations, isValid);
+
+		vector<double> throughputs;
+		size_t rhsCalls = 0;
+		for (size_t repeat = 0; repeat < repeats; ++repeat)
+		{
+			std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+			rhsCalls = scenario.body(scenario.operations, isValid);
+			std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
+
+			const double seconds = std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1).count();
+			throughputs.push_back(static_cast<double>(scenario.operations) / std::max(seconds, 1e-12));
+		}
+
+		ScenarioResult result;
+		result.name = scenario.name;
+		result.throughput = median(throughputs);
+		vector<double> deviations;
+		for (const double throughput : throughputs)
+		{
+			deviations.push_back(std::abs(throughput - result.throughput));
+		}
+		result.deviation = median(deviations);
+		result.rhsCalls = static_cast<double>(rhsCalls) / static_cast<double>(scenario.operations);
+		result.isValid = isValid;
+		return result;
+	}
+
+	//Pull the number following the key out of an entry of the baseline
+	bool readNumber(const string& entry, const string& key, double& value)
+	{
+		const size_t keyPosition = entry.find("\"" + key + "\"");
+		if (keyPosition == string::npos)
+		{
+			return false;
+		}
+		const size_t colon = entry.find(':', keyPosition);
+		if (colon == string::npos)
+		{
+			return false;
+		}
+		value = std::strtod(entry.c_str() + colon + 1, nullptr);
+		return true;
+	}
+
+	//Pull the string following the key out of the text (empty if it is not there)
+	string readString(const string& text, const string& key)
+	{
+		const size_t keyPosition = text.find("\"" + key + "\"");
+		const size_t begin = keyPosition == string::npos ? string::npos : text.find('"', text.find(':', keyPosition));
+		const size_t end = begin == string::npos ? string::npos : text.find('"', begin + 1);
+		return end == string::npos ? string() : text.substr(begin + 1, end - begin - 1);
+	}
+
+	//Describe the machine and build the throughputs were measured with so a reader knows which machine they hold for
+	string describeMachine()
+	{
+		std::ostringstream description;
+		description << "hardware threads " << std::thread::hardware_concurrency() << ", ";
+#if defined(_MSC_FULL_VER)
+		description << "MSVC " << _MSC_FULL_VER;
+#elif defined(__clang__)
+		description << "clang " << __clang_version__;
+#elif defined(__GNUC__)
+		description << "g++ " << __VERSION__;
+#else
+		description << "unknown compiler";
+#endif
+		return description.str();
+	}
+
+	//Read the baseline written by writeBaseline (the machine it was measured on and one object per scenario with its name, throughput, and rhs calls)
+	map<string, BaselineEntry> readBaseline(const string& fileName, string& machine)
+	{
+		map<string, BaselineEntry> baseline;
+		std::ifstream file(fileName);
+		if (!file)
+		{
+			return baseline;
+		}
+		std::stringstream buffer;
+		buffer << file.rdbuf();
+		const string text = buffer.str();
+
+		//Get the machine the throughputs were measured on
+		machine = readString(text.substr(0, text.find("\"scenarios\"")), "machine");
+
+		//Walk the scenario objects
+		size_t position = text.find("\"scenarios\"");
+		while (position != string::npos)
+		{
+			const size_t begin = text.find('{', position);
+			const size_t end = begin == string::npos ? string::npos : text.find('}', begin);
+			if (end == string::npos)
+			{
+				break;
+			}
+			const string entry = text.substr(begin, end - begin);
+
+			//Get the name
+			const string name = readString(entry, "name");
+			BaselineEntry values;
+			if (!name.empty() && readNumber(entry, "throughput", values.throughput) && readNumber(entry, "rhs_calls", values.rhsCalls))
+			{
+				baseline[name] = values;
+			}
+			position = end;
+		}
+
+		return baseline;
+	}
+
+	//Write the results as the new baseline
+	bool writeBaseline(const string& fileName, const vector<ScenarioResult>& results)
+	{
+		std::ofstream file(fileName);
+		if (!file)
+		{
+			return false;
+		}
+
+		file << "{\n\t\"machine\": \"" << describeMachine() << "\",\n\t\"scenarios\": [\n" << std::setprecision(6) << std::scientific;
+		for (size_t i = 0; i < results.size(); ++i)
+		{
+			file << "\t\t{ \"name\": \"" << results[i].name << "\", \"throughput\": " << results[i].throughput
+				<< ", \"deviation\": " << results[i].deviation << ", \"rhs_calls\": " << results[i].rhsCalls << " }"
+				<< (i + 1 < results.size() ? ",\n" : "\n");
+		}
+		file << "\t]\n}\n";
+
+		return static_cast<bool>(file);
+	}
+
+	//Get the checked in baseline, which sits next to this source, so the bench finds it whatever directory it is run from
+	string defaultBaseline()
+	{
+		const string source = __FILE__;
+		const size_t slash = source.find_last_of("/\\");
+		return (slash == string::npos ? string() : source.substr(0, slash + 1)) + "regression_baseline.json";
+	}
+
+	//Configuration the scenarios run the solver with
+	OdeSolverParams buildRegressionParams()
+	{
+		OdeSolverParams params;
+		params.upperError = 1e-6;
+		params.lowerError = 1e-9;
+		params.redutionFactor = 2.;
+		params.dt = .01;
+		params.minDt = .1;
+		params.maxDt = 2.;
+		params.minTableSize = 3;
+		params.maxTableSize = 6;
+		params.isStiff = false;
+		params.isLarge = false;
+		params.isFast = false;
+		params.useEuler = false;
+		params.useRK2 = false;
+		params.useRK4 = true;
+		return params;
+	}
+}
+
+//Time the fixed scenarios, compare them against the stored baseline, and fail if any regressed past the threshold.
+//The baseline defaults to the one checked in next to this source. Only the right hand side calls are the same on every machine, so
+//throughput only fails the run with --throughput, meant for the machine the baseline was written on (the baseline names it).
+//Usage: OdeSolverBench regress [baseline json] [threshold percent] [repeats] [--update] [--throughput]
+int runRegressionBench(int argc, char* argv[])
+{
+	//Pull the flags out of the positional arguments
+	bool update = false;
+	bool checkThroughput = false;
+	vector<const char*> arguments;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--update") == 0)
+		{
+			update = true;
+		}
+		else if (std::strcmp(argv[i], "--throughput") == 0)
+		{
+			checkThroughput = true;
+		}
+		else
+		{
+			arguments.push_back(argv[i]);
+		}
+	}
+	const string baselineName = arguments.size() > 0 ? arguments[0] : defaultBaseline();
+	const double threshold = (arguments.size() > 1 ? std::strtod(arguments[1], nullptr) : 15.0) / 100.0;
+	const size_t repeats = std::max(arguments.size() > 2 ? std::strtoul(arguments[2], nullptr, 10) : 7ul, 1ul);
+
+	const OdeSolverParams params = buildRegressionParams();
+
+	//Problems the scenarios work on
+	const BrusselatorProblem brusselator(32);
+	const LinearDiffusionProblem diffusion(1000);
+	const LorenzProblem lorenz;
+
+	//Filled tables for the error scenario
+	Richardson filledTables;
+	{
+		const vec ic = diffusion.getInitalCondition();
+		vec state(ic.size());
+		RK4 method;
+		method.initalize(ic);
+		filledTables.setErrorNorm(params);
+		filledTables.initalizeSteps(params.redutionFactor, 1e-5);
+		filledTables.BuildTables(params.maxTableSize, ic.size());
+		for (size_t i = 0; i < params.maxTableSize; ++i)
+		{
+			const int steps = 1 << i;
+			method.update(ic, state, 1e-5 / static_cast<double>(steps), 0.0, steps, &diffusion);
+			filledTables.append(i, 0, state);
+		}
+	}
+
+	//A finished run for the interpolation scenario
+	OdeSolver solvedLorenz(params);
+	solvedLorenz.run(&lorenz, lorenz.getInitalCondition(), 0.0, 20.0);
+
+	const vector<Scenario> scenarios = {
+		//One richardson table of RK4 rows the way runMethod builds it
+		{ "runMethod", 500, [&](const size_t operations, bool&)
+			{
+				size_t evaluations = 0;
+				const CountingOdeFun counted(&brusselator, evaluations);
+				const vec ic = brusselator.getInitalCondition();
+				vec state(ic.size());
+				RK4 method;
+				method.initalize(ic);
+				Richardson tables;
+				tables.setErrorNorm(params);
+				for (size_t operation = 0; operation < operations; ++operation)
+				{
+					tables.initalizeSteps(params.redutionFactor, params.dt);
+					tables.BuildTables(params.maxTableSize, ic.size());
+					for (size_t i = 0; i < params.maxTableSize; ++i)
+					{
+						const int steps = 1 << i;
+						method.update(ic, state, params.dt / static_cast<double>(steps), 0.0, steps, &counted);
+						tables.append(i, 0, state);
+					}
+				}
+				return evaluations;
+			} },
+
+		//Extrapolating a full table of a large state
+		{ "Richardson::error", 1000, [&](const size_t operations, bool&)
+			{
+				vec best;
+				double c = 0.0;
+				for (size_t operation = 0; operation < operations; ++operation)
+				{
+					filledTables.error(best, c);
+				}
+				return static_cast<size_t>(0);
+			} },
+
+		//Interpolating the saved results at times spread over the run
+		{ "getStateAndTime", 20000, [&](const size_t operations, bool& isValid)
+			{
+				double checksum = 0.0;
+				for (size_t operation = 0; operation < operations; ++operation)
+				{
+					const double time = 20.0 * static_cast<double>(operation) / static_cast<double>(operations);
+					checksum += solvedLorenz.getStateAndTime(SolverIF::SOLVER_TYPES::RUNGE_KUTTA_FOUR, time).getState()[0];
+				}
+				isValid &= std::isfinite(checksum);
+				return static_cast<size_t>(0);
+			} },
+
+		//A whole run of the Brusselator
+		{ "run", 3, [&](const size_t operations, bool&)
+			{
+				size_t evaluations = 0;
+				for (size_t operation = 0; operation < operations; ++operation)
+				{
+					OdeSolver solver(params);
+					solver.run(&brusselator, brusselator.getInitalCondition(), 0.0, brusselator.getEndTime());
+					evaluations += solver.getStats(SolverIF::SOLVER_TYPES::RUNGE_KUTTA_FOUR).rhsEvaluations;
+				}
+				return evaluations;
+			} } };
+
+	//Measure everything
+	vector<ScenarioResult> results;
+	for (const Scenario& scenario : scenarios)
+	{
+		results.push_back(measureScenario(scenario, repeats));
+	}
+
+	//Save the new baseline if asked
+	if (update)
+	{
+		if (!writeBaseline(baselineName, results))
+		{
+			cerr << "Could not write " << baselineName << "\n";
+			return 1;
+		}
+		cout << "Baseline written to " << baselineName << "\n";
+		return 0;
+	}
+
+	//Compare against the baseline
+	string baselineMachine;
+	const map<string, BaselineEntry> baseline = readBaseline(baselineName, baselineMachine);
+	if (baseline.empty())
+	{
+		cerr << "No baseline found in " << baselineName << " (run with --update to write one)\n";
+		return 1;
+	}
+	cout << "Comparing against " << baselineName << "\n"
+		<< "Baseline throughputs are from " << (baselineMachine.empty() ? string("an unrecorded machine") : baselineMachine)
+		<< (checkThroughput ? "" : " and are only reported (pass --throughput to check them on that machine)") << "\n";
+
+	bool regressed = false;
+	cout << std::setprecision(4);
+	for (const ScenarioResult& result : results)
+	{
+		cout << std::setw(18) << result.name << ": " << std::setw(10) << result.throughput << " ops/s (+/- " << result.deviation << "), "
+			<< result.rhsCalls << " rhs calls/op" << (result.isValid ? "" : " [INVALID RESULT]");
+		regressed |= !result.isValid;
+
+		const map<string, BaselineEntry>::const_iterator entry = baseline.find(result.name);
+		if (entry == baseline.cend())
+		{
+			cout << " [no baseline]\n";
+			continue;
+		}
+
+		//More evaluations than the threshold allows is a regression, and so is being slower when we were asked to check throughput
+		const double throughputChange = result.throughput / entry->second.throughput - 1.0;
+		const bool slower = checkThroughput && throughputChange < -threshold;
+		const bool moreCalls = result.rhsCalls > entry->second.rhsCalls * (1.0 + threshold);
+		regressed |= slower || moreCalls;
+
+		cout << "; throughput " << std::showpos << 100.0 * throughputChange << std::noshowpos << "% vs baseline"
+			<< (slower ? " [THROUGHPUT REGRESSION]" : "") << (moreCalls ? " [RHS CALL REGRESSION]" : "") << "\n";
+	}
+
+	cout << (regressed ? "Regressions found" : "No regressions") << " (threshold " << 100.0 * threshold << "%)\n";
+	return regressed ? 2 : 0;
+}
@@ -0,0 +1,133 @@
+#include "Benchmarks.h"
+#include "BenchProblems.h"
+#include "CancellationToken.h"
+#include "MethodStats.h"
+#include "OdeSolver.h"
+#include "OdeSolverParams.h"
+#include "SolverIF.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+using std::cerr;
+using std::cout;
+using std::ofstream;
+
+namespace
+{
+	//One method the suite measures
+	struct BenchMethod
+	{
+		SolverIF::SOLVER_TYPES type;
+		const char* name;
+	};
+
+	//Every method type in the solver, the implict ones are reported as unavailable until they are built
+	const BenchMethod benchMethods[] = {
+		{ SolverIF::SOLVER_TYPES::EULER, "Euler" },
+		{ SolverIF::SOLVER_TYPES::RUNGE_KUTTA_TWO, "RK2" },
+		{ SolverIF::SOLVER_TYPES::RUNGE_KUTTA_FOUR, "RK4" },
+		{ SolverIF::SOLVER_TYPES::IMPLICT_EULER, "ImplictEuler" },
+		{ SolverIF::SOLVER_TYPES::CRANK_NICOLSON, "CrankNicolson" } };
+
+	//Upper error tolerances the methods are run at (the lower one is three orders below)
+	const double benchTolerances[] = { 1e-3, 1e-4, 1e-5, 1e-6, 1e-7, 1e-8 };
+
+	//Build the parameters that run just the one method at the tolerance
+	OdeSolverParams buildBenchParams(const SolverIF::SOLVER_TYPES type, const double tolerance)
+	{
+		OdeSolverParams params;
+		params.upperError = tolerance;
+		params.lowerError = tolerance * 1e-3;
+		params.redutionFactor = 2.;
+		params.dt = 1e-3;
+		params.minDt = .1;
+		params.maxDt = 2.;
+		params.minTableSize = 3;
+		params.maxTableSize = 6;
+		params.smallestAllowableDt = 1e-9;
+		params.isStiff = false;
+		params.isLarge = false;
+		params.isFast = false;
+		params.useEuler = type == SolverIF::SOLVER_TYPES::EULER;
+		params.useRK2 = type == SolverIF::SOLVER_TYPES::RUNGE_KUTTA_TWO;
+		params.useRK4 = type == SolverIF::SOLVER_TYPES::RUNGE_KUTTA_FOUR;
+		params.useImplictEuler = type == SolverIF::SOLVER_TYPES::IMPLICT_EULER;
+		params.useCrank = type == SolverIF::SOLVER_TYPES::CRANK_NICOLSON;
+		return params;
+	}
+}
+
+//Run every method at every tolerance on each reference problem and write one work precision row per run.
+//A run is given a wall time budget so the explict methods on the stiff problems report how far they got instead of running for hours.
+//Usage: OdeSolverBench suite [csv file] [wall time per run] [problem name]
+int runWorkPrecision(int argc, char* argv[])
+{
+	const string csvName = argc > 1 ? argv[1] : "work_precision.csv";
+	const double wallBudget = argc > 2 ? std::strtod(argv[2], nullptr) : 10.0;
+	const string onlyProblem = argc > 3 ? argv[3] : "";
+
+	ofstream csv(csvName);
+	if (!csv)
+	{
+		cerr << "Could not open " << csvName << "\n";
+		return 1;
+	}
+	csv << "problem,method,tolerance,rhs_calls,wall_time,error,reference_error,finished\n";
+	csv << std::setprecision(6) << std::scientific;
+
+	const vector<unique_ptr<BenchProblem>> problems = buildBenchProblems();
+	for (const unique_ptr<BenchProblem>& problem : problems)
+	{
+		if (!onlyProblem.empty() && problem->getName() != onlyProblem)
+		{
+			continue;
+		}
+
+		//Get the reference once for the problem
+		double referenceError = 0.0;
+		const vec reference = problem->getReference(referenceError);
+		const vec ic = problem->getInitalCondition();
+		cout << problem->getName() << " (" << ic.size() << " components, reference error " << referenceError << ")\n";
+
+		for (const BenchMethod& method : benchMethods)
+		{
+			for (const double tolerance : benchTolerances)
+			{
+				try
+				{
+					OdeSolver solver(buildBenchParams(method.type, tolerance));
+
+					std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+					solver.run(problem.get(), ic, 0.0, problem->getEndTime(), CancellationToken(), wallBudget);
+					std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
+
+					//Measure where the method ended up
+					const StateVector& last = solver.getResults(method.type).back();
+					const bool finished = !last.getParams().isPartial;
+					const double error = BenchProblem::scaledError(last.getState(), reference);
+					const size_t rhsCalls = solver.getStats(method.type).rhsEvaluations;
+					const double wallTime = std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1).count();
+
+					csv << problem->getName() << "," << method.name << "," << tolerance << "," << rhsCalls << "," << wallTime << ","
+						<< error << "," << referenceError << "," << (finished ? 1 : 0) << "\n";
+					cout << "\t" << std::setw(14) << method.name << " tol " << std::setw(6) << tolerance << ": error " << std::setw(12) << error
+						<< ", rhs calls " << std::setw(10) << rhsCalls << ", " << wallTime << " s" << (finished ? "" : " (partial)") << "\n";
+				}
+				catch (std::exception& e)
+				{
+					//The method is not built or the run failed, keep going with the rest
+					csv << problem->getName() << "," << method.name << "," << tolerance << ",,,,," << "\n";
+					cout << "\t" << std::setw(14) << method.name << " tol " << std::setw(6) << tolerance << ": unavailable (" << e.what() << ")\n";
+				}
+			}
+		}
+	}
+
+	cout << "Work precision data written to " << csvName << "\n";
+	return 0;
+}